@@ -135,12 +135,12 @@ char player_name[MAX_CHARS] = "Player";
 bool vert_opt_flags[3] = {0}; // {enable, full_opt, verbose}
 
 
-extern bool clear_landscape_vbo, use_dense_voxels, tree_4th_branches, model_calc_tan_vect, water_is_lava, use_grass_tess, def_tex_compress, ship_cube_map_reflection;
+extern bool clear_landscape_vbo, use_dense_voxels, tree_4th_branches, model_calc_tan_vect, water_is_lava, use_grass_tess, def_tex_compress, ship_cube_map_reflection, fast_texture_compress, video_capture_drop_frames;
 extern bool flashlight_on, player_wait_respawn, camera_in_building, player_in_tunnel, player_on_moving_ww, player_on_escalator;
 extern int camera_flight, DISABLE_WATER, DISABLE_SCENERY, camera_invincible, onscreen_display, mesh_freq_filter, show_waypoints, last_inventory_frame;
 extern int tree_coll_level, GLACIATE, UNLIMITED_WEAPONS, destroy_thresh, MAX_RUN_DIST, mesh_gen_mode, mesh_gen_shape, map_drag_x, map_drag_y, player_in_water;
 extern unsigned NPTS, NRAYS, LOCAL_RAYS, GLOBAL_RAYS, DYNAMIC_RAYS, NUM_THREADS, MAX_RAY_BOUNCES, grass_density, max_unique_trees, shadow_map_sz;
-extern unsigned scene_smap_vbo_invalid, spheres_mode, max_cube_map_tex_sz, DL_GRID_BS;
+extern unsigned scene_smap_vbo_invalid, spheres_mode, max_cube_map_tex_sz, DL_GRID_BS, video_capture_format;
 extern float fticks, team_damage, self_damage, player_damage, smiley_damage, smiley_speed, tree_deadness, tree_dead_prob, lm_dz_adj, nleaves_scale, flower_density, universe_ambient_scale;
 extern float mesh_scale, tree_scale, mesh_height_scale, smiley_acc, hmv_scale, last_temp, grass_length, grass_width, branch_radius_scale, tree_height_scale, planet_update_rate;
 extern float MESH_START_MAG, MESH_START_FREQ, MESH_MAG_MULT, MESH_FREQ_MULT, def_tex_aniso;
@@ -149,7 +149,7 @@ extern point hmv_pos, camera_last_pos;
 extern colorRGBA sunlight_color;
 extern int coll_id[];
 extern float tree_lod_scales[4];
-extern string read_hmap_modmap_fn, write_hmap_modmap_fn, read_voxel_brush_fn, write_voxel_brush_fn, font_texture_atlas_fn;
+extern string read_hmap_modmap_fn, write_hmap_modmap_fn, read_voxel_brush_fn, write_voxel_brush_fn, font_texture_atlas_fn, waypoint_cache_dir;
 extern vector<bbox> team_starts;
 extern player_state *sstates;
 extern pt_line_drawer obj_pld;
@@ -1489,7 +1489,8 @@ void keyboard2(int key, int x, int y) { // handling of special keys
 		show_bool_option_change("Spectate", spectate);
 		break;
 
-	case GLUT_KEY_F9: // unused
+	case GLUT_KEY_F9: // toggle frame recording
+		toggle_video_recording();
 		break;
 
 	case GLUT_KEY_F10: // switch cloud model / toggle smoke_dlights
@@ -1832,6 +1833,8 @@ int load_config(string const &config_file) {
 	kwmb.add("use_model_lod_blocks", use_model_lod_blocks);
 	kwmb.add("flatten_tt_mesh_under_models", flatten_tt_mesh_under_models);
 	kwmb.add("def_texture_compress", def_tex_compress);
+	kwmb.add("fast_texture_compress", fast_texture_compress);
+	kwmb.add("video_capture_drop_frames", video_capture_drop_frames);
 	kwmb.add("smileys_chase_player", smileys_chase_player);
 	kwmb.add("disable_fire_delay", disable_fire_delay);
 	kwmb.add("disable_recoil", disable_recoil);
@@ -1920,6 +1923,7 @@ int load_config(string const &config_file) {
 	kwmu.add("tiled_terrain_gen_heightmap_sz", tiled_terrain_gen_heightmap_sz);
 	kwmu.add("game_mode_disable_mask", game_mode_disable_mask);
 	kwmu.add("show_map_view_fractal", show_map_view_fractal);
+	kwmu.add("video_capture_format", video_capture_format);
 
 	kw_to_val_map_t<float> kwmf(error);
 	kwmf.add("gravity", base_gravity);
@@ -2038,6 +2042,7 @@ int load_config(string const &config_file) {
 	kwms.add("write_heightmap_png", hmap_out_fn);
 	kwms.add("skybox_cube_map", skybox_cube_map_name);
 	kwms.add("assimp_alpha_exclude_str", assimp_alpha_exclude_str);
+	kwms.add("waypoint_cache_dir", waypoint_cache_dir);
 
 	while (read_str(fp, strc)) { // slow but should be OK: these ones require special handling
 		string const str(strc);
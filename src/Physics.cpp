@@ -1601,31 +1601,50 @@ bool physics_particle_manager::is_pos_valid(point const &pos) const {
 	return (pos.z > mesh_height[ypos][xpos] && pos.z > water_matrix[ypos][xpos]); // above mesh and water
 }
 
+template<typename T> void compact_by_mask(vector<T> &v, vector<unsigned char> const &remove) {
+	assert(v.size() == remove.size());
+	unsigned const num(v.size());
+	unsigned o(find(remove.begin(), remove.end(), 1) - remove.begin()); // elements before the first removed element don't move
+
+	for (unsigned i = o; i < num; ++i) {
+		if (!remove[i]) {v[o++] = v[i];}
+	}
+	v.resize(o);
+}
+
 void physics_particle_manager::apply_physics(float gravity, float terminal_velocity, bool emissive) {
 
-	if (parts.empty()) return;
+	if (pos.empty()) return;
 	//RESET_TIME;
-	unsigned o(0);
+	int const num((int)pos.size());
 	float const g_acc(base_gravity*GRAVITY*tstep*gravity), xy_damp(pow(0.98f, fticks));
-
-	for (unsigned i = 0; i < parts.size(); ++i) {
-		part_t &part(parts[i]);
-		part.v.z  = max(-terminal_velocity, (part.v.z - g_acc)); // apply gravity + terminal velocity
-		part.v.x *= xy_damp;
-		part.v.y *= xy_damp;
-		//point const p0(part.p);
-		part.p   += tstep*part.v; // add velocity to position
-		if (emissive) {part.c.set_c3(colorRGBA(1.0, 1.0-0.75*max(0.0f, -part.v.z/terminal_velocity), 0.0));} // varies from yellow to red-orange based on vz/vt
-		int cindex;
-		
-		//if (check_coll_line(p0, part.p, cindex, -1, 1, 0)) { // skip dynamic
-		if (check_point_contained_tree(part.p, cindex, 0)) { // skip dynamic
-			continue; // destroy particle, don't bounce
-			//part.p = cpos; vector3d bounce_v; calc_reflection_angle(part.v.get_norm(), bounce_v, cnorm); part.v = 0.9*part.v.mag()*bounce_v;
+	point *const p(pos.data());
+	vector3d *const v(vel.data());
+
+	for (int i = 0; i < num; ++i) { // integrate; written as a simple loop over the arrays so that it can be vectorized
+		v[i].z  = max(-terminal_velocity, (v[i].z - g_acc)); // apply gravity + terminal velocity
+		v[i].x *= xy_damp;
+		v[i].y *= xy_damp;
+		p[i]   += tstep*v[i]; // add velocity to position
+	}
+	if (emissive) {
+		for (int i = 0; i < num; ++i) { // varies from yellow to red-orange based on vz/vt
+			colors[i].set_c3(colorRGBA(1.0, 1.0-0.75*max(0.0f, -v[i].z/terminal_velocity), 0.0));
 		}
-		if (is_pos_valid(part.p)) {parts[o++] = part;} // above water and mesh - copy/compact
 	}
-	parts.resize(o);
+	check_points_contained_tree(pos, to_remove, 0); // skip dynamic; contained particles are destroyed, don't bounce
+	unsigned num_remove(0);
+
+#pragma omp parallel for schedule(static,1024) reduction(+:num_remove) if (num > 4096)
+	for (int i = 0; i < num; ++i) {
+		if (!to_remove[i] && !is_pos_valid(p[i])) {to_remove[i] = 1;} // must be above water and mesh
+		num_remove += to_remove[i];
+	}
+	if (num_remove > 0) { // stream compaction of all arrays
+		compact_by_mask(pos,    to_remove);
+		compact_by_mask(vel,    to_remove);
+		compact_by_mask(colors, to_remove);
+	}
 	//PRINT_TIME("Particle Physics"); // 0.07ms average / 0.24ms with collisions
 }
 
@@ -522,6 +522,7 @@ bool texture_t::is_texture_compressed() const {
 GLenum texture_t::calc_internal_format() const {
 	assert(ncolors >= 1 && ncolors <= 4);
 	if (is_16_bit_gray) {return GL_R16;} // compressed?
+	if (ncolors == 2 && is_texture_compressed()) {return GL_COMPRESSED_RG_RGTC2;} // BC5, compressed by stb_dxt in texture_utils.cpp
 	return get_internal_texture_format(ncolors, is_texture_compressed(), 0); // linear_space=0
 }
 GLenum texture_t::calc_format() const {
@@ -817,18 +818,28 @@ void texture_t::resize(int new_w, int new_h) { // Note: not thread safe
 
 	if (new_w == width && new_h == height) return; // already correct size
 	
-	if (omp_get_thread_num_3dw() != 0) {
-		std::cerr << "Error: Can't resize texture '" << name << "' on an OpenMP worker thread" << endl;
-		exit(1); // for now, this is fatal
-		return; // don't scale it?
-	}
 	assert(is_allocated());
 	assert(width > 0 && height > 0 && new_w > 0 && new_h > 0);
 	unsigned char *new_data(new unsigned char[new_w*new_h*ncolors]);
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // required to handle calls from from fix_word_alignment()
-	int const ret(gluScaleImage(calc_format(), width, height, get_data_format(), data, new_w, new_h, get_data_format(), new_data));
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-	if (ret) {cout << "GLU error during image scale: " << gluErrorString(ret) << "." << endl;}
+
+	if (omp_get_thread_num_3dw() != 0) { // can't make OpenGL/GLU calls on a worker thread, so use nearest neighbor filtering
+		unsigned const bpp(ncolors); // Note: 16-bit grayscale is stored as two 8-bit channels
+
+		for (int y = 0; y < new_h; ++y) {
+			int const src_y(min(height-1, (y*height)/new_h));
+
+			for (int x = 0; x < new_w; ++x) {
+				int const src_x(min(width-1, (x*width)/new_w));
+				memcpy((new_data + bpp*(y*new_w + x)), (data + bpp*(src_y*width + src_x)), bpp);
+			}
+		}
+	}
+	else {
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // required to handle calls from from fix_word_alignment()
+		int const ret(gluScaleImage(calc_format(), width, height, get_data_format(), data, new_w, new_h, get_data_format(), new_data));
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		if (ret) {cout << "GLU error during image scale: " << gluErrorString(ret) << "." << endl;}
+	}
 	free_data(); // only if size increases?
 	data   = new_data;
 	width  = new_w;
@@ -1856,7 +1867,7 @@ float texture_t::get_component(float u, float v, int comp) const {
 unsigned texture_t::get_gpu_mem() const {
 	if (!is_bound()) return 0;
 	unsigned mem(0);
-	if (is_texture_compressed()) {mem = (num_pixels()/16) * ((ncolors == 4) ? 16 : 8);} // assumes DXT1 8:1 RGB and DXT5 4:1 RGBA compression
+	if (is_texture_compressed()) {mem = (num_pixels()/16) * ((ncolors == 2 || ncolors == 4) ? 16 : 8);} // assumes DXT1 8:1 RGB, DXT5 4:1 RGBA, and BC5 2:1 RG compression
 	else {mem = num_bytes();}
 	if (use_mipmaps) {mem += mem/3;} // 33% overhead
 	return mem;
@@ -43,9 +43,9 @@ tree_type tree_types[NUM_TREE_TYPES] = { // not const - config file can override
 	tree_type(BARK6_TEX, PAPAYA_TEX,   1.0, 1.0, 1.0, 1.00, 2.0, 2.0, 0.5, 0.1,  0.0, colorRGBA(0.7, 0.6,  0.5,  1.0), WHITE)
 };
 
-vector<tree_cylin >   tree_builder_t::cylin_cache;
-vector<tree_branch>   tree_builder_t::branch_cache;
-vector<tree_branch *> tree_builder_t::branch_ptr_cache;
+thread_local vector<tree_cylin >   tree_builder_t::cylin_cache;
+thread_local vector<tree_branch>   tree_builder_t::branch_cache;
+thread_local vector<tree_branch *> tree_builder_t::branch_ptr_cache;
 
 
 bool has_any_billboard_coll(0), next_has_any_billboard_coll(0), tree_4th_branches(0);
@@ -2216,8 +2216,11 @@ void tree_cont_t::gen_trees_tt_within_radius(int x1, int y1, int x2, int y2, poi
 	rand_gen_t rgen;
 	generated = 1;
 
+	bool const allow_bushes(max_unique_trees == 0 || !have_cities()); // allow bushes unless there are cities, because we don't want instanced bushes placed there
+
 	if (tree_placer.have_decid_trees()) { // now add pre-placed trees within the city (TT mode)
 		shared_tree_data.ensure_init();
+		shared_tree_data.gen_missing(allow_bushes);
 		vector3d const xlate(-xoff2*DX_VAL, -yoff2*DY_VAL, 0.0);
 		cube_t const bounds(get_xval(x1), get_xval(x2), get_yval(y1), get_yval(y2), min_tree_h, max_tree_h); // Note: zvals are unused
 
@@ -2241,8 +2244,17 @@ void tree_cont_t::gen_trees_tt_within_radius(int x1, int y1, int x2, int y2, poi
 	float const height_thresh(get_median_height(tree_density_thresh));
 	unsigned const smod(3.321*XY_MULT_SIZE+1), tree_prob(max(1U, XY_MULT_SIZE/mod_num_trees));
 	unsigned const skip_val(max(1, int(1.0/tree_scale))); // similar to deterministic gen in scenery.cpp
-	bool const allow_bushes(max_unique_trees == 0 || !have_cities()); // allow bushes unless there are cities, because we don't want instanced bushes placed there
 	shared_tree_data.ensure_init();
+	shared_tree_data.gen_missing(allow_bushes); // shared data is fully created before placement
+	// each tree's rgen is seeded from its grid position, and shared tree data was created above, so trees can be generated in parallel after placement
+	struct pending_tree_t {
+		unsigned ix;
+		int ttype;
+		point pos;
+		rand_gen_t rgen;
+		pending_tree_t(unsigned ix_, int ttype_, point const &pos_, rand_gen_t const &rgen_) : ix(ix_), ttype(ttype_), pos(pos_), rgen(rgen_) {}
+	};
+	vector<pending_tree_t> pending;
 	mesh_xy_grid_cache_t density_gen[NUM_TREE_TYPES+1];
 
 	if (NONUNIFORM_TREE_DEN) { // i==0 is the coverage density map, i>0 are the per-tree type coverage maps
@@ -2298,9 +2310,15 @@ void tree_cont_t::gen_trees_tt_within_radius(int x1, int y1, int x2, int y2, poi
 				if (!adjust_tree_zval(pos, 0, ttype, 0, cur_tile)) continue; // create_bush=0
 			}
 			add_new_tree(rgen, ttype);
-			back().gen_tree(pos, 0, ttype, 0, 1, 0, rgen, 1.0, 1.0, 1.0, tree_4th_branches, allow_bushes);
+			pending.emplace_back((size() - 1), ttype, pos, rgen);
 		} // for j
 	} // for i
+#pragma omp parallel for schedule(dynamic,1)
+	for (int i = 0; i < (int)pending.size(); ++i) {
+		pending_tree_t &p(pending[i]);
+		operator[](p.ix).gen_tree(p.pos, 0, p.ttype, 0, 0, 0, p.rgen, 1.0, 1.0, 1.0, tree_4th_branches, allow_bushes); // add_cobjs=0
+	}
+	for (pending_tree_t const &p : pending) {operator[](p.ix).add_tree_collision_objects();} // not thread safe; added in the same order as before
 	calc_bcube();
 }
 
@@ -2396,6 +2414,26 @@ void tree_data_manager_t::ensure_init() {
 	last_rgi        = rand_gen_index;
 }
 
+// generate all shared tree data up front in parallel, seeded by ID, so that it doesn't depend on which placed tree binds to it first
+void tree_data_manager_t::gen_missing(bool allow_bushes) {
+
+	vector<unsigned> to_gen;
+	for (unsigned i = 0; i < size(); ++i) {if (!operator[](i).is_created()) {to_gen.push_back(i);}}
+	if (to_gen.empty()) return;
+	unsigned const num_per_type(max(1U, (unsigned)size()/NUM_TREE_TYPES)); // must agree with tree_cont_t::add_new_tree()
+
+#pragma omp parallel for schedule(dynamic,1)
+	for (int n = 0; n < (int)to_gen.size(); ++n) {
+		unsigned const id(to_gen[n]);
+		rand_gen_t rgen;
+		rgen.set_state((id + 1), (rand_gen_index + 1));
+		rgen.rand_mix();
+		tree temp_tree; // only used to build the shared data; no cobjs are added
+		temp_tree.bind_to_td(&operator[](id));
+		temp_tree.gen_tree(all_zeros, 0, min(int(id/num_per_type), NUM_TREE_TYPES-1), 0, 0, 0, rgen, 1.0, 1.0, 1.0, tree_4th_branches, allow_bushes);
+	}
+}
+
 void tree_data_manager_t::clear_context() {
 	for (iterator i = begin(); i != end(); ++i) {i->clear_context();}
 }
@@ -62,10 +62,14 @@ point get_scaled_upt();
 void add_player_ship_engine_light();
 
 
+thread_local bool is_background_thread(0); // set on std::threads that must not make OpenGL calls
+
+void mark_as_background_thread() {is_background_thread = 1;}
+
 #ifdef _OPENMP
-int omp_get_thread_num_3dw() {return omp_get_thread_num();} // where does this belong?
+int omp_get_thread_num_3dw() {return (is_background_thread ? 1 : omp_get_thread_num());} // where does this belong?
 #else
-int omp_get_thread_num_3dw() {return 0;}
+int omp_get_thread_num_3dw() {return (is_background_thread ? 1 : 0);}
 #endif
 
 void init_universe_display() {
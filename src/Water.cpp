@@ -675,6 +675,127 @@ inline void update_water_edges(int i, int j) {
 }
 
 
+// gather-form ripple solver: each cell sums the contributions of its neighbors into its own acc, so rows can be processed in parallel;
+// rval is read-only during the update, so acc can be updated in place; tiles where the ripples have decayed to zero are skipped
+class ripple_solver_t {
+	static int const TILE_SZ = 16;
+	// 00 0- -0 0+ +0 -- +- ++ -+  22  11
+	// 01 02 04 08 10 20 40 80 100 200 400
+	static unsigned short const dir_bits[8], opp_bits[8];
+	static int const dir_dx[8], dir_dy[8];
+	static float const dir_weights[8];
+
+	vector<unsigned short> in_mask, out_mask; // neighbors that add to this cell's acc when they're wet / neighbors inside the mesh
+	vector<unsigned char> wet, tile_active, tile_update;
+	int ntx=0, nty=0;
+
+	bool is_wet(int i, int j) const {return (wminside[i][j] && water_matrix[i][j] >= z_min_matrix[i][j]);}
+public:
+	void init_masks() { // must be called after watershed inside8 values are set
+		unsigned const num(XY_MULT_SIZE);
+		in_mask .resize(num);
+		out_mask.resize(num);
+		wet     .resize(num);
+		ntx = (MESH_X_SIZE + TILE_SZ - 1)/TILE_SZ;
+		nty = (MESH_Y_SIZE + TILE_SZ - 1)/TILE_SZ;
+		tile_active.resize(ntx*nty);
+		tile_update.resize(ntx*nty);
+
+		for (int i = 0; i < MESH_Y_SIZE; ++i) {
+			for (int j = 0; j < MESH_X_SIZE; ++j) {
+				unsigned short im(0), om(0);
+
+				for (unsigned d = 0; d < 8; ++d) {
+					int const y(i + dir_dy[d]), x(j + dir_dx[d]);
+					if (point_outside_mesh(x, y)) continue;
+					om |= dir_bits[d];
+					if (watershed_matrix[y][x].inside8 & opp_bits[d]) {im |= dir_bits[d];} // neighbor scatters into this cell
+				}
+				in_mask[i*MESH_X_SIZE + j] = im;
+				out_mask[i*MESH_X_SIZE + j] = om;
+			} // for j
+		} // for i
+	}
+	bool update(float rm_atten) { // returns true if any ripples are still active
+		if (in_mask.size() != (unsigned)XY_MULT_SIZE) {init_masks();} // mesh was resized
+		float const *const rval(ripple_rval[0]);
+		float *const acc(ripple_acc[0]);
+		int any_active(0);
+
+		// pass 1: determine wet cells, clamp small rvals, and find tiles with nonzero ripples
+#pragma omp parallel for schedule(static,1)
+		for (int ty = 0; ty < nty; ++ty) {
+			int const y1(ty*TILE_SZ), y2(min(y1+TILE_SZ, MESH_Y_SIZE));
+			for (int tx = 0; tx < ntx; ++tx) {tile_active[ty*ntx + tx] = 0;}
+
+			for (int i = y1; i < y2; ++i) {
+				for (int j = 0; j < MESH_X_SIZE; ++j) {
+					bool const w(is_wet(i, j));
+					wet[i*MESH_X_SIZE + j] = w;
+					if (w) {fix_fp_mag(ripple_rval[i][j]);}
+					if (ripple_rval[i][j] != 0.0 || ripple_acc[i][j] != 0.0) {tile_active[ty*ntx + j/TILE_SZ] = 1;}
+				}
+			} // for i
+		} // for ty
+		// a tile must be updated if it or any adjacent tile has ripples
+		for (int ty = 0; ty < nty; ++ty) {
+			for (int tx = 0; tx < ntx; ++tx) {
+				bool active(0);
+
+				for (int y = max(ty-1, 0); y <= min(ty+1, nty-1) && !active; ++y) {
+					for (int x = max(tx-1, 0); x <= min(tx+1, ntx-1) && !active; ++x) {active = tile_active[y*ntx + x];}
+				}
+				tile_update[ty*ntx + tx] = active;
+			}
+		} // for ty
+		// pass 2: gather neighbor contributions into acc, one row at a time
+#pragma omp parallel for schedule(dynamic,4) reduction(|:any_active)
+		for (int i = 0; i < MESH_Y_SIZE; ++i) {
+			unsigned char const *const tu(tile_update.data() + (i/TILE_SZ)*ntx);
+
+			for (int tx = 0; tx < ntx; ++tx) {
+				if (!tu[tx]) continue; // calm water
+				int const x1(tx*TILE_SZ), x2(min(x1+TILE_SZ, MESH_X_SIZE));
+
+				for (int j = x1; j < x2; ++j) {
+					int const ix(i*MESH_X_SIZE + j);
+					bool const wet_c(wet[ix] != 0);
+					unsigned short const im(in_mask[ix]), om(wet_c ? out_mask[ix] : 0);
+					if (!im && !om) continue; // no contributions
+					float const rc(rval[ix]);
+					float a(acc[ix]);
+
+					if (wet_c) {
+						fix_fp_mag(a);
+						a *= rm_atten;
+						if (fabs(a) > 1.0E-6) {any_active = 1;}
+					}
+					for (unsigned d = 0; d < 8; ++d) {
+						unsigned short const bit(dir_bits[d]);
+						if (!((im | om) & bit)) continue;
+						int const nix(ix + dir_dy[d]*MESH_X_SIZE + dir_dx[d]);
+						// a wet cell loses the difference to each neighbor, and gains the difference from each wet neighbor that scatters into it
+						float const mult(((om & bit) ? 1.0f : 0.0f) + (((im & bit) && wet[nix]) ? 1.0f : 0.0f));
+						a += mult*dir_weights[d]*(rval[nix] - rc);
+					}
+					if (wet_c) {fix_fp_mag(a);}
+					acc[ix] = a;
+				} // for j
+			} // for tx
+		} // for i
+		return (any_active != 0);
+	}
+};
+
+unsigned short const ripple_solver_t::dir_bits[8] = {0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x100};
+unsigned short const ripple_solver_t::opp_bits[8] = {0x08, 0x10, 0x02, 0x04, 0x80, 0x100, 0x20, 0x40};
+int const ripple_solver_t::dir_dx[8] = {-1,  0, 1, 0, -1, -1, 1,  1};
+int const ripple_solver_t::dir_dy[8] = { 0, -1, 0, 1, -1,  1, 1, -1};
+float const ripple_solver_t::dir_weights[8] = {1.0, 1.0, 1.0, 1.0, SQRTOFTWOINV, SQRTOFTWOINV, SQRTOFTWOINV, SQRTOFTWOINV};
+
+ripple_solver_t ripple_solver;
+
+
 void compute_ripples() {
 
 	if (DISABLE_WATER) return;
@@ -685,131 +806,53 @@ void compute_ripples() {
 	if (temperature > W_FREEZE_POINT && (start_ripple || first_water_run)) {
 		float const tstep(max(fticks, 0.25f)); // ensure some min amount of damping to prevent unstable ripples when the framerate is very high
 		float const rm_atten(pow(RIPPLE_MAT_ATTEN, tstep)), rdamp1(pow(RIPPLE_DAMP1, tstep)), rdamp2(RIPPLE_DAMP2*tstep);
-		start_ripple = 0;
-
-		for (int i = 0; i < MESH_Y_SIZE; ++i) {
-			for (int j = 0; j < MESH_X_SIZE; ++j) {
-				if (!wminside[i][j] || water_matrix[i][j] < z_min_matrix[i][j] /*|| !get_water_enabled(j, i)*/) continue;
-				short const i8(watershed_matrix[i][j].inside8);
-				fix_fp_mag(ripples[i][j].rval);
-				float const rmij(ripples[i][j].rval);
-				float &acc(ripples[i][j].acc);
-				fix_fp_mag(acc);
-				acc *= rm_atten;
-				if (!start_ripple && fabs(acc) > 1.0E-6) start_ripple = 1;
-
-				// 00 0- -0 0+ +0 -- +- ++ -+  22  11
-				// 01 02 04 08 10 20 40 80 100 200 400
-				if (point_interior_to_mesh(j, i)) { // fast mode
-					float const d0( rmij - ripples[i  ][j-1].rval);
-					if (i8 & 0x02)  ripples[i  ][j-1].acc += d0;
-					float const d2( rmij - ripples[i  ][j+1].rval);
-					if (i8 & 0x08)  ripples[i  ][j+1].acc += d2;
-					float const d4((rmij - ripples[i-1][j-1].rval)*SQRTOFTWOINV);
-					if (i8 & 0x20)  ripples[i-1][j-1].acc += d4;
-					float const d1( rmij - ripples[i-1][j  ].rval);
-					if (i8 & 0x04)  ripples[i-1][j  ].acc += d1;
-					float const d7((rmij - ripples[i-1][j+1].rval)*SQRTOFTWOINV);
-					if (i8 & 0x100) ripples[i-1][j+1].acc += d7;
-					float const d5((rmij - ripples[i+1][j-1].rval)*SQRTOFTWOINV);
-					if (i8 & 0x40)  ripples[i+1][j-1].acc += d5;
-					float const d3( rmij - ripples[i+1][j  ].rval);
-					if (i8 & 0x10)  ripples[i+1][j  ].acc += d3;
-					float const d6((rmij - ripples[i+1][j+1].rval)*SQRTOFTWOINV);
-					if (i8 & 0x80)  ripples[i+1][j+1].acc += d6;
-					acc -= d0 + d1 + d2 + d3 + d4 + d5 + d6 + d7;
-					fix_fp_mag(acc);
-					continue;
-				}
-				if (j > 0) {
-					float const dz(rmij - ripples[i][j-1].rval);
-					if (i8 & 0x02) ripples[i][j-1].acc += dz;
-					acc -= dz;
-
-					if (i > 0) {
-						float const dz((rmij - ripples[i-1][j-1].rval)*SQRTOFTWOINV);
-						if (i8 & 0x20) ripples[i-1][j-1].acc += dz;
-						acc -= dz;
-					}
-					if (i < MESH_Y_SIZE-1) {
-						float const dz((rmij - ripples[i+1][j-1].rval)*SQRTOFTWOINV);
-						if (i8 & 0x40) ripples[i+1][j-1].acc += dz;
-						acc -= dz;
-					}
-				}
-				if (i > 0) {
-					float const dz(rmij - ripples[i-1][j].rval);
-					if (i8 & 0x04) ripples[i-1][j].acc += dz;
-					acc -= dz;
-				}
-				if (j < MESH_X_SIZE-1) {
-					float const dz(rmij - ripples[i][j+1].rval);
-					if (i8 & 0x08) ripples[i][j+1].acc += dz;
-					acc -= dz;
-
-					if (i < MESH_Y_SIZE-1) {
-						float const dz((rmij - ripples[i+1][j+1].rval)*SQRTOFTWOINV);
-						if (i8 & 0x80) ripples[i+1][j+1].acc += dz;
-						acc -= dz;
-					}
-					if (i > 0) {
-						float const dz((rmij - ripples[i-1][j+1].rval)*SQRTOFTWOINV);
-						if (i8 & 0x100) ripples[i-1][j+1].acc += dz;
-						acc -= dz;
-					}
-				}
-				if (i < MESH_Y_SIZE-1) {
-					float const dz(rmij - ripples[i+1][j].rval);
-					if (i8 & 0x10) ripples[i+1][j].acc += dz;
-					acc -= dz;
-				}
-				fix_fp_mag(acc);
-			} // for j
-		} // for i
+		start_ripple = ripple_solver.update(rm_atten);
 		if (DEBUG_RIPPLE_TIME) dtime1 += GET_DELTA_TIME;
 		
+#pragma omp parallel for schedule(static,8)
 		for (int i = 0; i < MESH_Y_SIZE; ++i) {
 			for (int j = 0; j < MESH_X_SIZE; ++j) {
 				float ripple_zval(0.0);
 
 				if (wminside[i][j]) {
-					float const zval(rdamp1*(ripples[i][j].rval + rdamp2*ripples[i][j].acc)); // ripple wave height
+					float const zval(rdamp1*(ripple_rval[i][j] + rdamp2*ripple_acc[i][j])); // ripple wave height
 					ripple_zval = ((fabs(zval) < TOLERANCE) ? 0.0 : zval); // prevent small floating point numbers
 				}
 				if (wminside[i][j] == 1) { // dynamic water
 					int const wsi(watershed_matrix[i][j].wsi);
 					assert(size_t(wsi) < valleys.size());
 
-					if (water_matrix[i][j] < z_min_matrix[i][j] && fabs(ripples[i][j].rval) < 1.0E-4 && fabs(ripples[i][j].acc) < 1.0E-4) { // under ground - no ripple
+					if (water_matrix[i][j] < z_min_matrix[i][j] && fabs(ripple_rval[i][j]) < 1.0E-4 && fabs(ripple_acc[i][j]) < 1.0E-4) { // under ground - no ripple
 						if (update_iter) water_matrix[i][j] = valleys[wsi].zval;
 						continue;
 					}
 					float const depth(valleys[wsi].depth);
 
 					if (depth < 0) {
-						ripples[i][j].rval *= rm_atten;
+						ripple_rval[i][j] *= rm_atten;
 						if (update_iter) water_matrix[i][j] = valleys[wsi].zval;
 						continue;
 					}
 					float const zval(max(min(ripple_zval, depth), -depth)); // max ripple height equals water depth
-					ripples[i][j].rval = rm_atten*zval;
+					ripple_rval[i][j] = rm_atten*zval;
 					water_matrix[i][j] = valleys[wsi].zval + zval;
 				}
 				else if (wminside[i][j] == 2) { // fixed water
-					ripples[i][j].rval = rm_atten*ripple_zval;
+					ripple_rval[i][j] = rm_atten*ripple_zval;
 					water_matrix[i][j] = water_plane_z + min(MAX_RIPPLE_HEIGHT, ripple_zval);
 					water_matrix[i][j] = max(water_matrix[i][j], zbottom);
 				}
 				else if (update_iter) {
 					if (get_water_enabled(j, i)) {update_water_edges(i, j);}
-					else {ripples[i][j].rval = 0.0;} // not sure if this is correct, or if there is something else that should be done here
+					else {ripple_rval[i][j] = 0.0;} // not sure if this is correct, or if there is something else that should be done here
 				}
 			} // for j
 		} // for i
 		if (DEBUG_RIPPLE_TIME) dtime2 += GET_DELTA_TIME;
 	}
 	else { // no ripple
-		matrix_clear_2d(ripples);
+		matrix_clear_2d(ripple_rval);
+		matrix_clear_2d(ripple_acc);
 
 		// must clear ripples at least once at the beginning
 		if (NO_ICE_RIPPLES || counter == 0 || temperature > W_FREEZE_POINT) {
@@ -892,7 +935,7 @@ void add_splash(point const &pos, int xpos, int ypos, float energy, float radius
 
 	for (int i = y1; i <= y2; i++) {
 		for (int j = x1; j <= x2; j++) {
-			if (((i - ypos)*(i - ypos) + (j - xpos)*(j - ypos)) <= radsq && wminside[i][j]) {ripples[i][j].rval += splash_size;}
+			if (((i - ypos)*(i - ypos) + (j - xpos)*(j - ypos)) <= radsq && wminside[i][j]) {ripple_rval[i][j] += splash_size;}
 		}
 	}
 	start_ripple = 1;
@@ -927,10 +970,10 @@ void add_waves() { // add waves due to wind
 			float const wval(wind_amplitude*min(2.5f, sqrt(lwmag))*val*min(depth, 0.1f));
 			
 			if (wminside[y][x] == 2) { // outside water (oceans)
-				ripples[y][x].rval += wval + wave_amplitude*fticks_clamped*sin(wave_freq*wave_time + depth_scale*depth);
+				ripple_rval[y][x] += wval + wave_amplitude*fticks_clamped*sin(wave_freq*wave_time + depth_scale*depth);
 			}
-			else if (fabs(ripples[y][x].rval) < 0.1*wval) { // don't add wind if already rippling to prevent instability
-				ripples[y][x].rval += wval;
+			else if (fabs(ripple_rval[y][x]) < 0.1*wval) { // don't add wind if already rippling to prevent instability
+				ripple_rval[y][x] += wval;
 			}
 			start_ripple = 1;
 		}
@@ -1294,6 +1337,7 @@ void calc_watershed() {
 				watershed_matrix[i][j].inside8 = 0x1FF; // all outside water
 			}
 		}
+		ripple_solver.init_masks();
 		max_water_height = def_water_level;
 		min_water_height = def_water_level;
 		return;
@@ -1328,7 +1372,8 @@ void calc_watershed() {
 	}
 	calc_water_flow();
 	init_water_springs(NUM_WATER_SPRINGS);
-	matrix_clear_2d(ripples);
+	matrix_clear_2d(ripple_rval);
+	matrix_clear_2d(ripple_acc);
 	first_water_run = 1;
 
 	for (int i = 0; i < MESH_Y_SIZE; ++i) {
@@ -1370,6 +1415,7 @@ void calc_watershed() {
 			}
 		} // for j
 	} // for i
+	ripple_solver.init_masks();
 }
 
 
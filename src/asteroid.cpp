@@ -509,6 +509,7 @@ unsigned const AST_FIELD_MODEL   = AS_MODEL_HMAP;
 unsigned const NUM_AST_MODELS    = 40;
 unsigned const AST_FLD_MAX_NUM   = 1200;
 unsigned const AST_BELT_MAX_NS   = 10000;
+int      const ASTEROID_MT_MIN_SIZE = 1024; // min asteroids to use multiple threads for physics updates
 unsigned const AST_BELT_MAX_NP   = 4000;
 float    const AST_RADIUS_SCALE  = 0.04;
 float    const AST_AMBIENT_S     = 2.5;
@@ -1055,10 +1056,9 @@ void uasteroid_field::apply_physics(point_d const &pos_, point const &camera) {
 	if (!animate2 || empty()) return;
 	float const sphere_size(calc_sphere_size((pos + pos_), camera, AST_RADIUS_SCALE*radius));
 	if (sphere_size < 2.0) return; // asteroids are too small/far away
-
-	for (iterator i = begin(); i != end(); ++i) {
-		i->apply_field_physics(pos, radius);
-	}
+	int const num_asteroids((int)size());
+#pragma omp parallel for schedule(static, 256) if (num_asteroids >= ASTEROID_MT_MIN_SIZE)
+	for (int i = 0; i < num_asteroids; ++i) {operator[](i).apply_field_physics(pos, radius);} // independent per asteroid
 	if (sphere_size < 8.0) return; // asteroids are too small/far away
 
 	// check for collisions between asteroids
@@ -1117,7 +1117,9 @@ void uasteroid_belt_system::apply_physics(upos_point_type const &pos_, point con
 	//RESET_TIME;
 	calc_colliders();
 	upos_point_type const opn(orbital_plane_normal);
-	for (iterator i = begin(); i != end(); ++i) {i->apply_belt_physics(pos, opn, orbit_scale, colliders);}
+	int const num_asteroids((int)size());
+#pragma omp parallel for schedule(static, 256) if (num_asteroids >= ASTEROID_MT_MIN_SIZE)
+	for (int i = 0; i < num_asteroids; ++i) {operator[](i).apply_belt_physics(pos, opn, orbit_scale, colliders, colliders_bcube);} // independent per asteroid
 	calc_shadowers();
 	//PRINT_TIME("Physics"); // < 1ms
 	// no collision detection between asteroids as it's rare and too slow
@@ -1133,10 +1135,12 @@ void uasteroid_belt_planet::apply_physics(upos_point_type const &pos_, point con
 	if (planet) { // move all asteroids along the planet's orbit
 		upos_point_type const delta_pos(planet->pos - pos);
 		pos = planet->pos;
-
-		for (iterator i = begin(); i != end(); ++i) {
-			if (animate2) {i->rot_ang += fticks*i->rot_ang0;} // rotation
-			i->pos += delta_pos; // must always update pos, even when physics are disabled
+		int const num_asteroids((int)size());
+#pragma omp parallel for schedule(static, 256) if (num_asteroids >= ASTEROID_MT_MIN_SIZE)
+		for (int i = 0; i < num_asteroids; ++i) {
+			uasteroid &a(operator[](i));
+			if (animate2) {a.rot_ang += fticks*a.rot_ang0;} // rotation
+			a.pos += delta_pos; // must always update pos, even when physics are disabled
 		}
 	}
 	calc_shadowers();
@@ -1150,6 +1154,7 @@ void uasteroid_belt_system::add_potential_collider(point const &cpos, float crad
 	if (!univ_sphere_vis(cpos, 2.0f*(cradius + max_asteroid_radius)))     return; // expand radius somewhat
 	if (!sphere_might_intersect(cpos, cradius)) return;
 	colliders.push_back(sphere_t(cpos, cradius));
+	if (colliders.size() == 1) {colliders_bcube.set_from_sphere(cpos, cradius);} else {colliders_bcube.union_with_sphere(cpos, cradius);}
 }
 
 void uasteroid_belt_system::calc_colliders() {
@@ -1408,7 +1413,9 @@ void uasteroid::apply_field_physics(point const &af_pos, float af_radius) {
 }
 
 
-void uasteroid::apply_belt_physics(upos_point_type const &af_pos, upos_point_type const &op_normal, vector3d const &orbit_scale, vector<sphere_t> const &colliders) {
+void uasteroid::apply_belt_physics(upos_point_type const &af_pos, upos_point_type const &op_normal, vector3d const &orbit_scale,
+	vector<sphere_t> const &colliders, cube_t const &colliders_bcube)
+{
 
 	upos_point_type const dir(pos - af_pos);
 	rot_ang += 0.5*fticks*rot_ang0; // slow rotation
@@ -1419,6 +1426,7 @@ void uasteroid::apply_belt_physics(upos_point_type const &af_pos, upos_point_typ
 	float odist(orbital_dist);
 	if (orbit_scale.x != 1.0 || orbit_scale.y != 1.0) {odist *= get_elliptical_orbit_radius(op_normal, orbit_scale, orbit_dir.get_norm());} // elliptical orbit scale - slow
 	pos = af_pos + orbit_dir*(odist/orbit_dir.mag()); // renormalize for constant distance
+	if (colliders.empty() || !colliders_bcube.contains_pt_exp(pos, 1.01*radius)) return; // early reject; 1% extra for FP error
 
 	for (vector<sphere_t>::const_iterator i = colliders.begin(); i != colliders.end(); ++i) {
 		if (dist_less_than(pos, i->pos, (radius + i->radius))) {
@@ -35,7 +35,8 @@ public:
 	void gen_belt(upos_point_type const &pos_offset, vector3d const &orbital_plane_normal, vector3d const vxy[2],
 		float belt_radius, float belt_width, float belt_thickness, float max_radius, float &ri_max, float &plane_dmax);
 	void apply_field_physics(point const &af_pos, float af_radius);
-	void apply_belt_physics(upos_point_type const &af_pos, upos_point_type const &op_normal, vector3d const &orbit_scale, vector<sphere_t> const &colliders);
+	void apply_belt_physics(upos_point_type const &af_pos, upos_point_type const &op_normal, vector3d const &orbit_scale,
+		vector<sphere_t> const &colliders, cube_t const &colliders_bcube);
 	void draw(point_d const &pos_, point const &camera, shader_t &s, pt_line_drawer &pld) const;
 	void destroy();
 	void set_velocity(vector3d const &v) {velocity = v;}
@@ -135,6 +136,7 @@ class uasteroid_belt_system : public uasteroid_belt {
 
 	ussystem *system;
 	vector<sphere_t> colliders;
+	cube_t colliders_bcube; // union of collider bounding cubes
 
 	virtual void gen_asteroid_placements();
 	void add_potential_collider(point const &cpos, float cradius);
@@ -13,6 +13,7 @@
 #include "file_utils.h"
 #include "openal_wrap.h"
 #include "format_text.h"
+#include "fast_atof.h"
 #include <fstream>
 
 
@@ -1005,6 +1006,110 @@ void create_xyz_groups(int *group_ids, bool use_vbo) {
 }
 
 
+// ************ Fast text file tokenizer ************
+
+// each FILE is only read by a single thread, so we can use the unlocked variants of getc()/ungetc()
+#ifdef _MSC_VER
+inline int  getc_fast  (FILE *fp)        {return _getc_nolock(fp);}
+inline void ungetc_fast(int c, FILE *fp) {_ungetc_nolock(c, fp);}
+#else
+inline int  getc_fast  (FILE *fp)        {return getc_unlocked(fp);}
+inline void ungetc_fast(int c, FILE *fp) {ungetc(c, fp);}
+#endif
+
+enum {NUM_TOKEN_INT=0, NUM_TOKEN_UINT, NUM_TOKEN_FP};
+unsigned const MAX_NUM_TOKEN_LEN = 64;
+
+// reads a number into buf after skipping leading whitespace, following the same rules as the fscanf() %i/%u/%f conversions;
+// the first character that isn't part of the number is pushed back; returns 0 if no digits were read
+bool read_number_token(FILE *fp, char buf[MAX_NUM_TOKEN_LEN], unsigned mode) {
+	unsigned len(0), num_digits(0);
+	int c(getc_fast(fp));
+	while (isspace(c)) {c = getc_fast(fp);} // skip leading whitespace
+
+	auto add_char = [&]() {
+		if (len+1 >= MAX_NUM_TOKEN_LEN) return 0; // too long; treat as an error
+		buf[len++] = c;
+		c = getc_fast(fp);
+		return 1;
+	};
+	auto read_digits = [&](bool hex) {
+		while (isdigit(c) || (hex && isxdigit(c))) {
+			if (!add_char()) return 0;
+			++num_digits;
+		}
+		return 1;
+	};
+	bool valid(1);
+	if (c == '-' || c == '+') {add_char();} // optional sign
+	
+	if (mode == NUM_TOKEN_INT && c == '0') { // check for hex prefix
+		add_char();
+		++num_digits;
+		if (c == 'x' || c == 'X') {add_char(); num_digits = 0; valid = read_digits(1);}
+	}
+	valid &= read_digits(0);
+
+	if (mode == NUM_TOKEN_FP && valid) {
+		if (c == '.') {valid = (add_char() && read_digits(0));}
+		
+		if (valid && num_digits > 0 && (c == 'e' || c == 'E')) { // exponent
+			valid = add_char();
+			if (valid && (c == '-' || c == '+')) {valid = add_char();}
+			valid &= read_digits(0);
+		}
+	}
+	if (c != EOF) {ungetc_fast(c, fp);}
+	buf[len] = 0; // add null terminator
+	return (valid && num_digits > 0);
+}
+
+bool read_int(FILE *fp, int &val) {
+	char buf[MAX_NUM_TOKEN_LEN];
+	if (!read_number_token(fp, buf, NUM_TOKEN_INT)) return 0;
+	val = (int)strtol(buf, nullptr, 0); // base 0 handles hex and octal like %i
+	return 1;
+}
+bool read_uint(FILE *fp, unsigned &val) {
+	char buf[MAX_NUM_TOKEN_LEN];
+	if (!read_number_token(fp, buf, NUM_TOKEN_UINT)) return 0;
+	val = (unsigned)strtoul(buf, nullptr, 10);
+	return 1;
+}
+bool read_uint64(FILE *fp, uint64_t &val) {
+	char buf[MAX_NUM_TOKEN_LEN];
+	if (!read_number_token(fp, buf, NUM_TOKEN_UINT)) return 0;
+	val = strtoull(buf, nullptr, 10);
+	return 1;
+}
+bool read_float(FILE *fp, float &val) {
+	char buf[MAX_NUM_TOKEN_LEN];
+	if (!read_number_token(fp, buf, NUM_TOKEN_FP)) return 0;
+	val = Assimp::fast_atof(buf);
+	return 1;
+}
+bool read_double(FILE *fp, double &val) {
+	char buf[MAX_NUM_TOKEN_LEN];
+	if (!read_number_token(fp, buf, NUM_TOKEN_FP)) return 0;
+	val = strtod(buf, nullptr); // doubles need full precision
+	return 1;
+}
+bool read_str(FILE *fp, char *val) { // val must have space for at least MAX_CHARS chars
+	unsigned len(0);
+	int c(getc_fast(fp));
+	while (isspace(c)) {c = getc_fast(fp);} // skip leading whitespace
+	
+	while (c != EOF && !isspace(c)) {
+		val[len++] = c;
+		if (len+1 >= MAX_CHARS) break; // max of 255 chars, like %255s
+		c = getc_fast(fp);
+	}
+	if (len < MAX_CHARS-1 && c != EOF) {ungetc_fast(c, fp);} // push back the trailing whitespace
+	val[len] = 0; // add null terminator
+	return (len > 0);
+}
+
+
 void read_or_calc_zval(FILE *fp, point &pos, float interp_rad, float radius, geom_xform_t const &xf) {
 
 	pos.z = 0.0;
@@ -1021,7 +1126,7 @@ string read_quoted_string(FILE *fp, unsigned &line_num) {
 	bool in_quote(0);
 
 	while (1) {
-		int const c(getc(fp));
+		int const c(getc_fast(fp));
 		if (is_EOF(c)) {return str;} // end of file
 		else if (c == '"') { // quote
 			if (in_quote) {return str;} // end of quote ends the string, even if it's empty
@@ -1162,11 +1267,11 @@ unsigned read_cube(FILE *fp, geom_xform_t const &xf, cube_t &c) {
 bool read_block_comment(FILE *fp) {
 
 	while (1) {
-		int c(getc(fp));
+		int c(getc_fast(fp));
 		if (is_EOF(c)) return 0; // early EOF, unterminated block comment
 		if (c != '*' ) continue; // not end of block comment
 		while (1) {
-			c = getc(fp);
+			c = getc_fast(fp);
 			if (is_EOF(c)) return 0; // early EOF, unterminated block comment
 			if (c == '/' ) return 1; // done/success
 			if (c != '*' ) break; // not a block comment end, exit to outer loop and look for another '*'
@@ -1188,6 +1293,7 @@ int read_coll_obj_file(const char *coll_obj_file, geom_xform_t xf, coll_obj cobj
 	assert(coll_obj_file != NULL);
 	FILE *fp;
 	if (!open_file(fp, coll_obj_file, "collision object")) return 0;
+	setvbuf(fp, nullptr, _IOFBF, (1<<16)); // use a larger buffer to reduce the number of reads for large files
 	char str[MAX_CHARS] = {0};
 	unsigned line_num(1), npoints(0), indir_dlight_ix(0), prev_light_ix_start(0);
 	int end(0), use_z(0), use_vel(0), ivals[3];
@@ -1208,10 +1314,10 @@ int read_coll_obj_file(const char *coll_obj_file, geom_xform_t xf, coll_obj cobj
 	
 	while (!end) { // available: hou
 		assert(fp != NULL);
-		int letter(getc(fp));
+		int letter(getc_fast(fp));
 
 		if (!is_end_of_string(letter)) {
-			int const next_letter(getc(fp));
+			int const next_letter(getc_fast(fp));
 
 			if (letter == '/' && next_letter == '*') { // start of block comment
 				if (!read_block_comment(fp)) {return read_error(fp, "block_comment", coll_obj_file);}
@@ -1221,7 +1327,7 @@ int read_coll_obj_file(const char *coll_obj_file, geom_xform_t xf, coll_obj cobj
 				string keyword;
 				keyword.push_back(letter);
 				letter = next_letter;
-				while (!is_end_of_string(letter)) {keyword.push_back(letter); letter = getc(fp);}
+				while (!is_end_of_string(letter)) {keyword.push_back(letter); letter = getc_fast(fp);}
 
 				if (0) {}
 				// long name aliases remapped to single character
@@ -1414,7 +1520,7 @@ int read_coll_obj_file(const char *coll_obj_file, geom_xform_t xf, coll_obj cobj
 			break;
 
 		case '#': // line comment
-			do {letter = getc(fp);} while (letter != '\n' && letter != EOF && letter != 0);
+			do {letter = getc_fast(fp);} while (letter != '\n' && letter != EOF && letter != 0);
 			if (letter == '\n') {++line_num;}
 			break;
 
@@ -1778,7 +1884,7 @@ int read_coll_obj_file(const char *coll_obj_file, geom_xform_t xf, coll_obj cobj
 			break;
 
 		case 'S': // sphere: x y z radius
-			if (fscanf(fp, "%f%f%f%f", &cobj.points[0].x, &cobj.points[0].y, &cobj.points[0].z, &cobj.radius) != 4) {
+			if (!read_vector(fp, cobj.points[0]) || !read_float(fp, cobj.radius)) {
 				return read_error(fp, "collision sphere", coll_obj_file);
 			}
 			check_layer(has_layer);
@@ -1789,7 +1895,7 @@ int read_coll_obj_file(const char *coll_obj_file, geom_xform_t xf, coll_obj cobj
 
 		case 'C': // cylinder: x1 y1 z1 x2 y2 z2 r1 r2
 		case 'k': // capsule: x1 y1 z1 x2 y2 z2 r1 r2
-			if (fscanf(fp, "%f%f%f%f%f%f%f%f", &cobj.points[0].x, &cobj.points[0].y, &cobj.points[0].z, &cobj.points[1].x, &cobj.points[1].y, &cobj.points[1].z, &cobj.radius, &cobj.radius2) != 8) {
+			if (!read_vector(fp, cobj.points[0]) || !read_vector(fp, cobj.points[1]) || !read_float(fp, cobj.radius) || !read_float(fp, cobj.radius2)) {
 				return read_error(fp, "collision cylinder/capsule", coll_obj_file);
 			}
 			assert(cobj.radius >  0.0 || cobj.radius2 >  0.0);
@@ -1803,7 +1909,7 @@ int read_coll_obj_file(const char *coll_obj_file, geom_xform_t xf, coll_obj cobj
 			break;
 
 		case 'z': // torus: x y z dir_x dir_y dir_z ro ri
-			if (fscanf(fp, "%f%f%f%f%f%f%f%f", &cobj.points[0].x, &cobj.points[0].y, &cobj.points[0].z, &cobj.norm.x, &cobj.norm.y, &cobj.norm.z, &cobj.radius, &cobj.radius2) != 8) {
+			if (!read_vector(fp, cobj.points[0]) || !read_vector(fp, cobj.norm) || !read_float(fp, cobj.radius) || !read_float(fp, cobj.radius2)) {
 				return read_error(fp, "collision torus", coll_obj_file);
 			}
 			assert(cobj.radius > 0.0 && cobj.radius2 > 0.0);
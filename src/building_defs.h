@@ -875,6 +875,18 @@ unsigned get_face_mask(unsigned dim, bool dir);
 unsigned get_skip_mask_for_xy(bool dim);
 // functions in building_interact.cc and building_gameplay.cc
 void gen_sound_thread_safe(unsigned id, point const &pos, float gain=1.0, float pitch=1.0, float gain_scale=1.0, bool skip_if_already_playing=0);
+struct deferred_sound_t {
+	unsigned id;
+	point pos;
+	float gain, pitch;
+	bool skip_if_already_playing, is_zombie=0, alert_other_zombies=0, high_priority=0; // for zombie sounds, id is the zombie index and pos is in building space
+	deferred_sound_t(unsigned id_, point const &pos_, float gain_, float pitch_, bool siap) : id(id_), pos(pos_), gain(gain_), pitch(pitch_), skip_if_already_playing(siap) {}
+	deferred_sound_t(unsigned zombie_ix, point const &pos_bs, float gain_, float pitch_, bool alert, bool hp) :
+		id(zombie_ix), pos(pos_bs), gain(gain_), pitch(pitch_), skip_if_already_playing(0), is_zombie(1), alert_other_zombies(alert), high_priority(hp) {}
+};
+void set_deferred_sounds_for_thread(vector<deferred_sound_t> *sounds);
+bool defer_zombie_sound(point const &sound_pos_bs, unsigned zombie_ix, bool alert_other_zombies, bool high_priority, float gain, float pitch);
+void play_deferred_sounds(vector<deferred_sound_t> const &sounds);
 inline void gen_sound_thread_safe_at_player(unsigned id, float gain=1.0, float pitch=1.0, bool skip_if_already_playing=0) {
 	gen_sound_thread_safe(id, get_camera_pos(), gain, pitch, 1.0, skip_if_already_playing);
 }
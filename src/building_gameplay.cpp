@@ -3488,6 +3488,8 @@ float get_closest_building_sound(point const &at_pos, point &sound_pos, float fl
 }
 
 void maybe_play_zombie_sound(point const &sound_pos_bs, unsigned zombie_ix, bool alert_other_zombies, bool high_priority, float gain, float pitch) {
+	// if called from a parallel building update, the decision is deferred until sounds are played serially in building order
+	if (defer_zombie_sound(sound_pos_bs, zombie_ix, alert_other_zombies, high_priority, gain, pitch)) return;
 	unsigned const NUM_ZSOUNDS = 5;
 	static rand_gen_t rgen;
 	static double next_time_all(0.0), next_times[NUM_ZSOUNDS] = {};
@@ -2772,18 +2772,41 @@ bool building_interior_t::is_cube_close_to_doorway(cube_t const &c, cube_t const
 	// assume all doors are the same size and use the last for reference, but pad by 1.5x anyway; upper bound on the door bcube when open any amount in any direction
 	float const door_width(max(dmin, max(door_stacks.back().dx(), door_stacks.back().dy())));
 	test_cube.expand_by_xy(1.5*door_width);
-	
+	auto is_close_to_ds([&](door_stack_t const &ds) { // test_cube check is an optimization
+		return (test_cube.intersects(ds) && is_cube_close_to_door(c, dmin, (inc_open && door_opens_inward(ds, room)), ds, ds.get_check_dirs(), (check_open_dir ? ds.open_dir : 2)));
+	});
 	if (!room.is_all_zeros()) { // don't go outside the original room
 		if (!room.intersects_xy(c)) {cout << "Bad room cube: " << TXTS(room) << TXTS(c) << endl;}
 		assert(room.intersects_xy(c)); // can't test zval in case of ball in pool
 		cube_t room_exp(room);
 		room_exp.expand_by_xy(0.1*door_width); // small amount to include wall width
 		test_cube.intersect_with_cube_xy(room_exp);
+
+		if (omp_get_thread_num_3dw() == 0) { // placement queries are repeated many times per room; only check door stacks near this room; cache is not thread safe
+			room_door_stacks_cache_t &cache(room_ds_cache);
+
+			if (cache.room != room || cache.door_width != door_width || cache.num_door_stacks != door_stacks.size()) { // rebuild for this room
+				cache.room            = room;
+				cache.door_width      = door_width;
+				cache.num_door_stacks = door_stacks.size();
+				cache.ds_ixs.clear();
+
+				for (unsigned i = 0; i < door_stacks.size(); ++i) {
+					if (room_exp.intersects_xy(door_stacks[i])) {cache.ds_ixs.push_back(i);} // test_cube is contained in room_exp
+				}
+			}
+			for (unsigned ix : cache.ds_ixs) {
+				if (is_close_to_ds(door_stacks[ix])) return 1;
+			}
+			return is_cube_close_to_open_wall(c, door_width);
+		}
 	}
 	for (door_stack_t const &ds : door_stacks) { // interior doors
-		if (!test_cube.intersects(ds)) continue; // optimization
-		if (is_cube_close_to_door(c, dmin, (inc_open && door_opens_inward(ds, room)), ds, ds.get_check_dirs(), (check_open_dir ? ds.open_dir : 2))) return 1;
+		if (is_close_to_ds(ds)) return 1;
 	}
+	return is_cube_close_to_open_wall(c, door_width);
+}
+bool building_interior_t::is_cube_close_to_open_wall(cube_t const &c, float door_width) const {
 	for (cube_t const &w : open_walls) { // open walls count as doorways, even though there's no door
 		cube_t wall_exp(w);
 		bool const dim(w.dy() < w.dx());
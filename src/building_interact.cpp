@@ -43,14 +43,34 @@ bool ceiling_fan_is_on(room_object_t &obj, vect_room_object_t const &objs);
 bool object_has_something_on_it(room_object_t const &obj, vect_room_object_t const &objs, vect_room_object_t::const_iterator objs_end);
 
 // Note: pos is in camera space
+thread_local vector<deferred_sound_t> *deferred_sounds(nullptr); // if set, sounds are queued here rather than played, so that they're played in a deterministic order
+
+void maybe_play_zombie_sound(point const &sound_pos_bs, unsigned zombie_ix, bool alert_other_zombies, bool high_priority, float gain, float pitch);
+
+void set_deferred_sounds_for_thread(vector<deferred_sound_t> *sounds) {deferred_sounds = sounds;}
+
+bool defer_zombie_sound(point const &sound_pos_bs, unsigned zombie_ix, bool alert_other_zombies, bool high_priority, float gain, float pitch) {
+	if (!deferred_sounds) return 0;
+	deferred_sounds->emplace_back(zombie_ix, sound_pos_bs, gain, pitch, alert_other_zombies, high_priority);
+	return 1;
+}
+
 void gen_sound_thread_safe(unsigned id, point const &pos, float gain, float pitch, float gain_scale, bool skip_if_already_playing) {
 	assert(gain > 0.0 && pitch > 0.0 && gain_scale > 0.0);
 	float const dist(p2p_dist(get_camera_pos(), pos)), dscale(10.0*CAMERA_RADIUS*gain_scale); // distance at which volume is halved
 	gain *= dscale/(dist + dscale);
 	if (gain < 0.025) return; // too soft to hear
+	if (deferred_sounds) {deferred_sounds->emplace_back(id, pos, gain, pitch, skip_if_already_playing); return;}
 #pragma omp critical(gen_sound)
 	gen_sound(id, pos, gain, pitch, 0, zero_vector, skip_if_already_playing);
 }
+void play_deferred_sounds(vector<deferred_sound_t> const &sounds) {
+	for (deferred_sound_t const &s : sounds) {
+		if (s.is_zombie) {maybe_play_zombie_sound(s.pos, s.id, s.alert_other_zombies, s.high_priority, s.gain, s.pitch); continue;} // uses global state
+#pragma omp critical(gen_sound)
+		gen_sound(s.id, s.pos, s.gain, s.pitch, 0, zero_vector, s.skip_if_already_playing);
+	}
+}
 
 // lights
 
@@ -1116,6 +1136,7 @@ void building_t::toggle_door_state(unsigned door_ix, bool player_in_this_buildin
 	assert(interior);
 	door_t &door(interior->get_door(door_ix));
 	door.toggle_open_state(/*by_player*/player_in_this_building); // allow partial open/animated door if player is in this building
+	++interior->door_state_version;
 	// we changed the door state, but navigation should adapt to this, except for doors on stairs (which are special)
 	if ( door.on_stairs) {invalidate_nav_graph();} // any in-progress paths may have people walking to and stopping at closed/locked doors
 	if (!door.get_for_closet()) {interior->door_state_updated = 1;} // required for AI navigation logic to adjust to this change; what about backrooms doors?
@@ -1267,7 +1288,10 @@ void building_t::doors_next_frame(point const &player_pos) { // player_pos is in
 					if (open_area.contains_pt_exp_xy_only(person.pos, person.radius)) {is_blocked = 1; break;}
 				}
 			}
-			if (is_blocked) {d->open = 1;} // push open
+			if (is_blocked) { // push open
+				if (!d->open) {++interior->door_state_version;}
+				d->open = 1;
+			}
 			else if (d->open_amt == 1.0) {toggle_door_state((d - interior->doors.begin()), 1, 1, d->get_cube_center());} // auto close
 		}
 		if (!d->next_frame()) continue;
@@ -1285,7 +1309,9 @@ void building_t::doors_next_frame(point const &player_pos) { // player_pos is in
 
 	if (interior->door_state_updated && has_mall()) { // check mall store gates
 		for (store_doorway_t &d : interior->mall_info->store_doorways) {
+			bool const was_closed(d.closed);
 			int const moved(d.next_frame());
+			if (d.closed != was_closed) {++interior->door_state_version;}
 			updated |= bool(moved);
 			if (moved > 1) {gen_sound_thread_safe(SOUND_METAL_DOOR, local_to_camera_space(d.get_cube_center()), 1.0);} // fully open or closed
 		}
@@ -20,10 +20,11 @@ bool  const INDIR_BLDG_ENABLE  = 1;
 unsigned const INDIR_LIGHT_FLOOR_SPAN = 5; // in number of floors, generally an odd number to represent current floor and floors above/below; 0 is unlimited
 unsigned const INDIR_LIGHT_BATCH_SIZE = 4; // for USE_BKG_THREAD=1 mode
 float const ATTIC_LIGHT_RADIUS_SCALE  = 2.0; // larger radius in attic, since space is larger
+float const LIGHT_VIS_CELL_SIZE       = 0.25; // in units of floor spacing; camera cell size for reusing light occlusion results
 
 vector<point> enabled_bldg_lights;
 
-extern bool camera_in_building, player_in_walkway, player_in_uge, some_person_has_idle_animation;
+extern bool camera_in_building, player_in_walkway, player_in_uge, some_person_has_idle_animation, building_has_open_ext_door;
 extern int display_mode, display_framerate, camera_surf_collide, animate2, frame_counter, building_action_key, player_in_basement, player_in_elevator, player_in_attic;
 extern unsigned LOCAL_RAYS, MAX_RAY_BOUNCES, NUM_THREADS;
 extern float fticks, indir_light_step_sz;
@@ -1828,9 +1829,15 @@ float get_radius_for_room_light(room_object_t const &obj) {
 	return radius;
 }
 
-void check_for_shadow_caster(vect_cube_with_ix_t const &cubes, cube_t const &light_bcube, point const &lpos,
+void add_shadow_caster(vect_cube_with_ix_t &cubes, cube_t &cubes_bcube, cube_t const &c, unsigned ix) {
+	if (cubes.empty()) {cubes_bcube = c;} else {cubes_bcube.union_with_cube(c);}
+	cubes.emplace_back(c, ix);
+}
+void check_for_shadow_caster(vect_cube_with_ix_t const &cubes, cube_t const &cubes_bcube, cube_t const &light_bcube, point const &lpos,
 	float dmax, bool has_stairs, vector3d const &xlate, unsigned &shadow_caster_hash)
 {
+	if (cubes.empty() || !cubes_bcube.intersects(light_bcube)) return; // no objects within light area of effect
+
 	for (cube_with_ix_t const &c : cubes) {
 		if (lpos.z < c.z1())            continue; // light is below the object's bottom; assumes lights are spotlights pointed downward
 		if (!c.intersects(light_bcube)) continue; // object not within light area of effect
@@ -1860,8 +1867,8 @@ void check_for_shadow_caster(vect_cube_with_ix_t const &cubes, cube_t const &lig
 		hash_mix_point(center, shadow_caster_hash);
 	} // for c
 }
-void check_for_dynamic_shadow_casters(building_t const &b, vect_cube_with_ix_t &ped_bcubes, vect_cube_with_ix_t const &moving_objs,
-	cube_t const &light_bcube, point const &lpos, float dmax, bool has_stairs, vector3d const &xlate, bool check_people, unsigned &shadow_caster_hash)
+void check_for_dynamic_shadow_casters(building_t const &b, vect_cube_with_ix_t &ped_bcubes, cube_t &ped_bcubes_bc, vect_cube_with_ix_t const &moving_objs,
+	cube_t const &moving_objs_bc, cube_t const &light_bcube, point const &lpos, float dmax, bool has_stairs, vector3d const &xlate, bool check_people, unsigned &shadow_caster_hash)
 {
 	if (check_people && animate2) { // update shadow_caster_hash for moving people, but not for lamps, because their light points toward the floor
 		if (ped_bcubes.empty()) { // get all cubes on first light
@@ -1870,16 +1877,16 @@ void check_for_dynamic_shadow_casters(building_t const &b, vect_cube_with_ix_t &
 				// if this person is waiting and their location isn't changing,
 				// assume they have an idle animation playing and use the frame counter to make sure their shadows are updated each frame
 				unsigned const ix((some_person_has_idle_animation && p.waiting_start > 0) ? frame_counter : 0);
-				ped_bcubes.emplace_back(p.get_bcube(), ix);
+				add_shadow_caster(ped_bcubes, ped_bcubes_bc, p.get_bcube(), ix);
 			}
 		}
-		check_for_shadow_caster(ped_bcubes, light_bcube, lpos, dmax, has_stairs, xlate, shadow_caster_hash);
+		check_for_shadow_caster(ped_bcubes, ped_bcubes_bc, light_bcube, lpos, dmax, has_stairs, xlate, shadow_caster_hash);
 	}
 	// update shadow_caster_hash for moving objects
-	check_for_shadow_caster(moving_objs, light_bcube, lpos, dmax, has_stairs, xlate, shadow_caster_hash);
+	check_for_shadow_caster(moving_objs, moving_objs_bc, light_bcube, lpos, dmax, has_stairs, xlate, shadow_caster_hash);
 }
 // rat_t/spider_t/snake_t
-template<typename T> void get_animal_shadow_casters(vector<T> &animals, vect_cube_with_ix_t &moving_objs, vector3d const &xlate, unsigned base_ix) {
+template<typename T> void get_animal_shadow_casters(vector<T> &animals, vect_cube_with_ix_t &moving_objs, cube_t &moving_objs_bc, vector3d const &xlate, unsigned base_ix) {
 	for (auto i = animals.begin(); i != animals.end(); ++i) {
 		if (!i->is_moving() || i->no_shadows()) continue;
 		// calculate which animals are visible to the player and consider those for shadow casters;
@@ -1887,7 +1894,7 @@ template<typename T> void get_animal_shadow_casters(vector<T> &animals, vect_cub
 		// assumes non-vertical/hanging animals (such as spiders) may cast a shadow far below them
 		cube_t const bcube(i->get_bcube());
 		i->shadow_non_visible = (i->get_upv().z > 0.99 && !camera_pdu.cube_visible(bcube + xlate));
-		if (!i->shadow_non_visible) {moving_objs.emplace_back(bcube, (i - animals.begin() + base_ix));} // only add if shadow visible
+		if (!i->shadow_non_visible) {add_shadow_caster(moving_objs, moving_objs_bc, bcube, (i - animals.begin() + base_ix));} // only add if shadow visible
 	} // for i
 }
 
@@ -1923,6 +1930,36 @@ bool add_dlight_if_visible(point const &pos, float radius, colorRGBA const &colo
 	return 1;
 }
 
+void light_vis_cache_t::begin_frame(point const &camera_bs, unsigned const new_key[KEY_LEN], unsigned num_objs) {
+	if (!std::equal(new_key, new_key+KEY_LEN, key)) { // new camera cell/floor, or doors/objects changed; invalidate all results
+		std::copy(new_key, new_key+KEY_LEN, key);
+		++cell_epoch;
+		++pos_epoch;
+	}
+	else if (camera_bs != camera_pos) {++pos_epoch;} // camera moved within its cell; invalidate occluded results only
+	camera_pos = camera_bs;
+
+	if (query_cubes.size() < num_objs) {
+		query_cubes.resize(num_objs);
+		vis_epoch  .resize(num_objs, 0);
+		occ_epoch  .resize(num_objs, 0);
+		query_flags.resize(num_objs, 0);
+	}
+}
+int light_vis_cache_t::lookup(unsigned ix, cube_t const &c, uint8_t flags) const {
+	if (ix >= query_cubes.size() || query_flags[ix] != flags || query_cubes[ix] != c) return -1; // different query
+	if (vis_epoch[ix] == cell_epoch) return 0;
+	if (occ_epoch[ix] == pos_epoch ) return 1;
+	return -1;
+}
+void light_vis_cache_t::store(unsigned ix, cube_t const &c, uint8_t flags, bool occluded) {
+	if (ix >= query_cubes.size()) return;
+	query_cubes[ix] = c;
+	query_flags[ix] = flags;
+	vis_epoch  [ix] = (occluded ? 0 : cell_epoch);
+	occ_epoch  [ix] = (occluded ? pos_epoch : 0);
+}
+
 // Note: non const because this caches light_bcubes
 void building_t::add_room_lights(vector3d const &xlate, unsigned building_id, bool camera_in_building, bool sec_camera_mode,
 	occlusion_checker_noncity_t const &oc, vect_cube_with_ix_t &ped_bcubes, cube_t &lights_bcube)
@@ -1980,12 +2017,23 @@ void building_t::add_room_lights(vector3d const &xlate, unsigned building_id, bo
 	vector<unsigned> L_stairs_rooms; // there can be two for stacked part houses
 	vect_cube_t cuts_above, cuts_below, cuts_above_nonvis; // only used when player is in the building
 	vect_cube_with_ix_t moving_objs;
+	cube_t moving_objs_bc, ped_bcubes_bc; // bounds of moving_objs and ped_bcubes
 	cube_t floor_above_region, floor_below_region; // filters for lights on the floors above/below based on stairs
 	bool saw_open_stairs(0), camera_in_mall(0);
 	ped_bcubes.clear();
 	bool const track_lights(0 && camera_in_building && !sec_camera_mode && animate2); // used for debugging
 	bool const camera_above_ground_floor(camera_z > ground_floor_z2), camera_feet_above_basement(player_feet_zval >= ground_floor_z1);
 	if (track_lights) {enabled_bldg_lights.clear();}
+	light_vis_cache_t &vis_cache(interior->room_geom->light_vis_cache);
+
+	if (check_occlusion) {
+		float const cell_sz(LIGHT_VIS_CELL_SIZE*window_vspacing);
+		unsigned const cam_flags(camera_in_building + (::camera_in_building << 1) + (sec_camera_mode << 2) + (building_has_open_ext_door << 3) +
+			((player_building == this) << 4) + (player_in_basement << 5));
+		unsigned const key[light_vis_cache_t::KEY_LEN] = {unsigned(int(floor(camera_bs.x/cell_sz))), unsigned(int(floor(camera_bs.y/cell_sz))),
+			unsigned(int(floor((camera_bs.z - ground_floor_z1)/window_vspacing))), interior->door_state_version, (unsigned)objs.size(), cam_flags};
+		vis_cache.begin_frame(camera_bs, key, objs.size());
+	}
 
 	if (camera_in_building) {
 		run_light_motion_detect_logic(camera_rot);
@@ -2124,9 +2172,9 @@ void building_t::add_room_lights(vector3d const &xlate, unsigned building_id, bo
 		else if (point_in_mall(camera_rot) || point_in_industrial(camera_rot)) {} // optimization: no dynamic animal shadows in malls or industrial areas
 		else { // add a base index to each animal group to make all moving objects unique
 			// Note: sewer_rats, pet_rats, sewer_spiders, and pet_snakes don't cast shadows
-			get_animal_shadow_casters(interior->room_geom->rats,    moving_objs, xlate, 10000);
-			get_animal_shadow_casters(interior->room_geom->spiders, moving_objs, xlate, 20000);
-			get_animal_shadow_casters(interior->room_geom->snakes,  moving_objs, xlate, 30000);
+			get_animal_shadow_casters(interior->room_geom->rats,    moving_objs, moving_objs_bc, xlate, 10000);
+			get_animal_shadow_casters(interior->room_geom->spiders, moving_objs, moving_objs_bc, xlate, 20000);
+			get_animal_shadow_casters(interior->room_geom->snakes,  moving_objs, moving_objs_bc, xlate, 30000);
 		}
 	}
 	//highres_timer_t timer("Lighting", camera_in_building); // 13.8ms => 13.1ms => 12.7ms => 3.6ms => 3.2ms => 0.81
@@ -2138,7 +2186,7 @@ void building_t::add_room_lights(vector3d const &xlate, unsigned building_id, bo
 	for (auto i = objs.begin(); i != objs_end; ++i) {
 		if (camera_near_building && !walkway_only) {
 			// build moving objects vector
-			if (i->is_moving() && i->is_visible()) {moving_objs.emplace_back(*i, (i - objs.begin() + 1));}
+			if (i->is_moving() && i->is_visible()) {add_shadow_caster(moving_objs, moving_objs_bc, *i, (i - objs.begin() + 1));}
 			// handle light emitting objects in the player's building
 			room_object const type(i->type);
 			bool const is_tv_or_monitor_thats_on(i->is_tv_or_monitor() && i->is_tv_monitor_on()); // TV or monitor that's on, powered, and not broken
@@ -2631,7 +2679,16 @@ void building_t::add_room_lights(vector3d const &xlate, unsigned building_id, bo
 		if (!is_visible_in_reflection && !is_rot_cube_visible(clipped_bc, xlate, 1)) continue; // VFC - post clip; inc_mirror_reflections=1
 		// occlusion culling (expensive); skip basement check for mall lights viewed through skylights
 		if (in_camera_room && (in_retail_room || room.is_industrial())) {} // skip occlusion check for large open rooms
-		else if (check_occ && !clipped_bc.contains_pt(camera_rot) && check_obj_occluded(clipped_bc, camera_bs, oc, 0, 0, mall_light_vis)) continue;
+		else if (check_occ && !clipped_bc.contains_pt(camera_rot)) { // check cached result from a previous frame first
+			unsigned const light_ix(i - objs.begin());
+			int occluded(vis_cache.lookup(light_ix, clipped_bc, mall_light_vis));
+
+			if (occluded < 0) {
+				occluded = check_obj_occluded(clipped_bc, camera_bs, oc, 0, 0, mall_light_vis);
+				vis_cache.store(light_ix, clipped_bc, mall_light_vis, occluded);
+			}
+			if (occluded) continue;
+		}
 		bool const in_industrial(room.is_industrial()), tall_retail(in_retail_room && has_tall_retail()); // narrower for industrial ceiling lights and a bit lower for tall retail
 		bool const hanging(!wall_light && !is_lamp && (i->flags & RO_FLAG_ROTATING)); // rotated/broken light
 		float bwidth(in_industrial ? 0.125 : (tall_retail ? 0.24 : 0.25)); // as close to 180 degree FOV as we can get without shadow clipping
@@ -2682,7 +2739,7 @@ void building_t::add_room_lights(vector3d const &xlate, unsigned building_id, bo
 				// use full light radius for attics since they're more open
 				float const dshadow_radius((is_in_attic ? 1.0 : (reduced_shadows ? RETAIL_SMAP_DSCALE : PERSON_INT_SMAP_DSCALE))*light_radius);
 				if (building_action_key) {force_smap_update = 1;} // toggling a door state or interacting with objects invalidates shadows in the building for that frame
-				check_for_dynamic_shadow_casters(*this, ped_bcubes, moving_objs, clipped_bc, lpos_rot, dshadow_radius,
+				check_for_dynamic_shadow_casters(*this, ped_bcubes, ped_bcubes_bc, moving_objs, moving_objs_bc, clipped_bc, lpos_rot, dshadow_radius,
 					stairs_light, xlate, (check_building_people && !is_lamp), shadow_caster_hash); // no people shadows for lam[s
 			}
 		}
@@ -2860,7 +2917,7 @@ void building_t::add_room_lights(vector3d const &xlate, unsigned building_id, bo
 					shadow_caster_hash ^= 0xdeadbeef; // update hash when player enters or leaves the light's area
 				}
 				if (!force_smap_update && ((camera_near_building && camera_bs.z > clipped_area.z1()) || camera_bs.z > z)) {
-					check_for_dynamic_shadow_casters(*this, ped_bcubes, moving_objs, clipped_area, lpos,
+					check_for_dynamic_shadow_casters(*this, ped_bcubes, ped_bcubes_bc, moving_objs, moving_objs_bc, clipped_area, lpos,
 						0.0, room_has_stairs, xlate, check_building_people, shadow_caster_hash); // dmax=0
 				}
 				hash_mix_point(lpos, shadow_caster_hash); // update when light (sun/moon) pos changes
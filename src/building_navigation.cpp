@@ -18,8 +18,8 @@ float const COLL_RADIUS_SCALE   = 0.75; // somewhat smaller than radius, but lar
 int player_hiding_frame(0);
 building_dest_t cur_player_building_loc, prev_player_building_loc;
 room_object_t player_hiding_obj;
-vect_cube_t reused_avoid_cubes[2]; // temporary that's reused across frames and people
-bool debug_mode(0);
+thread_local vect_cube_t reused_avoid_cubes[2]; // temporary that's reused across frames and people; per-thread since buildings are updated in parallel
+thread_local bool debug_mode(0);
 
 extern bool player_is_hiding, player_on_escalator, player_in_tunnel;
 extern int frame_counter, display_mode, animate2, player_in_elevator;
@@ -305,12 +305,104 @@ class building_nav_graph_t {
 		point path_pt;
 		float g_score=0.0, f_score=0.0;
 	};
+	class a_star_arena_t { // per-thread search state reused across calls; node records are only valid when their stamp matches the current search
+		vector<a_star_node_state_t> state;
+		vector<unsigned> stamp, heap, heap_pos; // heap of open node indices ordered by f_score, and each node's position in the heap
+		vector<uint8_t> closed;
+		unsigned cur_stamp=0;
+		static unsigned const NOT_IN_HEAP = UINT_MAX;
+
+		bool heap_less(unsigned a, unsigned b) const { // ties go to the higher index, matching the order of the std::priority_queue this replaced
+			float const fa(state[a].f_score), fb(state[b].f_score);
+			return (fa < fb || (fa == fb && a > b));
+		}
+		void heap_set(unsigned pos, unsigned n) {heap[pos] = n; heap_pos[n] = pos;}
+
+		void sift_up(unsigned pos) {
+			unsigned const n(heap[pos]);
+
+			while (pos > 0) {
+				unsigned const parent((pos - 1) >> 1);
+				if (!heap_less(n, heap[parent])) break;
+				heap_set(pos, heap[parent]);
+				pos = parent;
+			}
+			heap_set(pos, n);
+		}
+		void sift_down(unsigned pos) {
+			unsigned const n(heap[pos]), sz(heap.size());
+
+			while (1) {
+				unsigned child(2*pos + 1);
+				if (child >= sz) break;
+				if (child+1 < sz && heap_less(heap[child+1], heap[child])) {++child;}
+				if (!heap_less(heap[child], n)) break;
+				heap_set(pos, heap[child]);
+				pos = child;
+			}
+			heap_set(pos, n);
+		}
+	public:
+		vector<a_star_node_state_t> const &get_state() const {return state;}
+
+		void start_search(unsigned num_nodes) {
+			if (stamp.size() < num_nodes) {
+				state   .resize(num_nodes);
+				stamp   .resize(num_nodes, 0);
+				heap_pos.resize(num_nodes, NOT_IN_HEAP);
+				closed  .resize(num_nodes, 0);
+			}
+			if (++cur_stamp == 0) {std::fill(stamp.begin(), stamp.end(), 0); cur_stamp = 1;} // wraparound
+			heap.clear();
+		}
+		a_star_node_state_t &get_node(unsigned n) { // resets the node state on first access in this search
+			assert(n < stamp.size());
+
+			if (stamp[n] != cur_stamp) {
+				stamp   [n] = cur_stamp;
+				state   [n] = a_star_node_state_t();
+				heap_pos[n] = NOT_IN_HEAP;
+				closed  [n] = 0;
+			}
+			return state[n];
+		}
+		bool is_open  (unsigned n) const {return (stamp[n] == cur_stamp && heap_pos[n] != NOT_IN_HEAP);}
+		bool is_closed(unsigned n) const {return (stamp[n] == cur_stamp && closed[n]);}
+		bool heap_empty() const {return heap.empty();}
+
+		void push_or_decrease(unsigned n) { // n must have been accessed with get_node(), and f_score can only decrease
+			if (heap_pos[n] == NOT_IN_HEAP) {heap_pos[n] = heap.size(); heap.push_back(n);}
+			sift_up(heap_pos[n]);
+		}
+		unsigned pop_and_close() {
+			assert(!heap.empty());
+			unsigned const n(heap.front());
+			heap_pos[n] = NOT_IN_HEAP;
+			closed  [n] = 1;
+			unsigned const last(heap.back());
+			heap.pop_back();
+			if (!heap.empty()) {heap_set(0, last); sift_down(0);}
+			return n;
+		}
+	};
+	struct failed_search_t { // inputs that affect whether any path exists, ignoring the exact start and end points
+		unsigned room1, room2, has_key;
+		float zval;
+		bool use_stairs, gameplay_mode;
+		bool operator==(failed_search_t const &s) const {
+			return (room1 == s.room1 && room2 == s.room2 && has_key == s.has_key && zval == s.zval && use_stairs == s.use_stairs && gameplay_mode == s.gameplay_mode);
+		}
+	};
 
 	unsigned num_rooms=0, num_stairs=0;
 	float floor_spacing=0.0, stairs_extend=0.0;
 	bool has_pg_ramp=0, has_mall_ent=0;
 	vector<node_t> nodes; // {rooms, stairs, mall entrance stairs, parking garage ramp}
 	mutable vector<building_cube_nav_grid> nav_grids; // for use with backrooms; cached during path finding
+	// A* searches that exhausted the graph without reaching the goal; these are the most expensive searches, and they're often repeated by
+	// many people heading for the same unreachable room; cleared when any door state changes
+	mutable vector<failed_search_t> failed_searches;
+	mutable unsigned failed_searches_door_version=0;
 	node_t       &get_node(unsigned room)       {assert(room < nodes.size()); return nodes[room];}
 	node_t const &get_node(unsigned room) const {assert(room < nodes.size()); return nodes[room];}
 	unsigned get_stairs_end() const {return (num_stairs + num_rooms + has_mall_ent);}
@@ -891,30 +983,33 @@ public:
 		assert(room1 < nodes.size() && room2 < nodes.size());
 		assert(room1 != room2); // but one can be the stairs in the same room as the other
 		path.clear();
-		vector<a_star_node_state_t> state(nodes.size());
-		vector<uint8_t> open(nodes.size(), 0), closed(nodes.size(), 0); // tentative/already evaluated nodes
-		std::priority_queue<pair<float, unsigned> > open_queue;
+		failed_search_t const search_key{room1, room2, has_key, cur_pt.z, use_stairs, in_building_gameplay_mode()};
+		
+		if (failed_searches_door_version != building.interior->door_state_version) { // doors have changed since the last failure was recorded
+			failed_searches.clear();
+			failed_searches_door_version = building.interior->door_state_version;
+		}
+		if (std::find(failed_searches.begin(), failed_searches.end(), search_key) != failed_searches.end()) return 0; // known to be unreachable
+		static thread_local a_star_arena_t arena; // AI update may run in multiple threads
+		arena.start_search(nodes.size());
 		point dest_pos;
 		if (custom_dest) {dest_pos = *custom_dest;}
 		else {dest_pos = get_node(room2).get_center(cur_pt.z);} // Note: approximate, actual dest may be different
-		a_star_node_state_t &start(state[room1]);
+		a_star_node_state_t &start(arena.get_node(room1));
 		start.g_score = 0.0;
 		start.f_score = p2p_dist_xy(cur_pt, dest_pos); // estimated total cost from start to goal through current
 		start.path_pt = cur_pt;
-		open[room1]   = 1;
-		open_queue.push(make_pair(-start.f_score, room1));
+		arena.push_or_decrease(room1);
 
-		while (!open_queue.empty()) {
-			unsigned const cur(open_queue.top().second);
-			open_queue.pop();
+		while (!arena.heap_empty()) {
+			unsigned const cur(arena.pop_and_close());
 			node_t const &cur_node(get_node(cur));
-			closed[cur] = 1;
-			open  [cur] = 0;
+			a_star_node_state_t const &cur_state(arena.get_node(cur));
 			bool reached_goal(0);
 
 			for (auto i = cur_node.conn_rooms.begin(); i != cur_node.conn_rooms.end(); ++i) {
 				assert(i->ix < nodes.size());
-				if (closed[i->ix]) continue; // already closed (duplicate)
+				if (arena.is_closed(i->ix)) continue; // already closed (duplicate)
 				bool const is_goal(i->ix == room2);
 				node_t const &conn_node(get_node(i->ix)); // connected room, stairs, or ramp
 				if (conn_node.is_vert_conn() && !use_stairs && !is_goal)                continue; // skip stairs/ramp in this mode
@@ -923,29 +1018,31 @@ public:
 				point const node_pt((cur == room1) ? cur_pt   : cur_node .get_center(cur_pt.z));
 				point const next_pt(is_goal        ? dest_pos : conn_node.get_center(cur_pt.z));
 				// Note: in the case of split rooms such as prison visitation rooms, this conn may not be reachable from the previous one, but there's no easy to account for this
-				a_star_node_state_t &sn(state[i->ix]);
+				bool const was_open(arena.is_open(i->ix));
+				a_star_node_state_t &sn(arena.get_node(i->ix));
 				vector2d const &pt(i->pt[up_or_down]); // point in doorway, etc.
-				float const dist_through_cur(state[cur].g_score + p2p_dist_xy(node_pt, pt) + p2p_dist_xy(pt, next_pt));
+				float const dist_through_cur(cur_state.g_score + p2p_dist_xy(node_pt, pt) + p2p_dist_xy(pt, next_pt));
 				float new_g_score(dist_through_cur);
 				// in the case of long hallways, the shortest path may pass between doors/adjacencies rather than through the center of the room/node,
 				// so we take that into account here by calculating the straight line path between room entrance and exit without going through the center
-				point const &prev_edge_pt(state[cur].path_pt); // point in doorway, etc.
-				float const dist_without_last_seg(state[cur].g_score - p2p_dist_xy(node_pt, prev_edge_pt));
+				point const &prev_edge_pt(cur_state.path_pt); // point in doorway, etc.
+				float const dist_without_last_seg(cur_state.g_score - p2p_dist_xy(node_pt, prev_edge_pt));
 				float const dist_door_to_door(dist_without_last_seg + p2p_dist_xy(pt, prev_edge_pt));
 				min_eq(new_g_score, dist_door_to_door); // dist_door_to_door is always smaller?
-				if (!open[i->ix]) {open[i->ix] = 1;}
-				else if (new_g_score >= sn.g_score) continue; // not better
+				if (was_open && new_g_score >= sn.g_score) continue; // not better
 				sn.came_from_ix = cur;
 				sn.path_pt.assign(pt.x, pt.y, cur_pt.z);
 				reached_goal |= is_goal; // Note: can't call reconstruct_path() until the iteration is done in case there's a second door that's closer
 				sn.g_score = new_g_score;
 				sn.f_score = sn.g_score + p2p_dist_xy(next_pt, dest_pos);
-				open_queue.push(make_pair(-sn.f_score, i->ix));
+				arena.push_or_decrease(i->ix);
 			} // for i
 			if (reached_goal) { // done, reconstruct path (in reverse)
-				return reconstruct_path(state, avoid, building, cur_pt, radius, room2, room1, ped_ix, is_first_path, up_or_down, ped_rseed, custom_dest, req_custom_dest, path);
+				return reconstruct_path(arena.get_state(), avoid, building, cur_pt, radius, room2, room1, ped_ix, is_first_path, up_or_down, ped_rseed, custom_dest, req_custom_dest, path);
 			}
 		} // end while()
+		if (failed_searches.size() >= 256) {failed_searches.clear();} // keep the linear search short
+		failed_searches.push_back(search_key);
 		return 0; // failed - no path from room1 to room2
 	}
 }; // end building_nav_graph_t
@@ -1097,8 +1194,8 @@ bool building_t::are_rooms_connected_without_using_room_or_door(unsigned room1,
 	assert(room_exclude != room1 && room_exclude != room2);
 	if (room1 == room2) return 1;
 	bool const use_bit_mask(num_rooms <= 64); // almost always true, except for buildings with malls
-	static vector<unsigned> pend; // reused across calls
-	static vector<uint8_t> seen; // reused across calls
+	static thread_local vector<unsigned> pend; // reused across calls
+	static thread_local vector<uint8_t> seen; // reused across calls
 	uint64_t seen_mask(0);
 	pend.clear();
 	pend.push_back(room1);
@@ -3361,7 +3458,10 @@ int building_t::ai_room_update(person_t &person, float delta_dir, unsigned perso
 	if (player_in_this_building || enable_bl_update) {person.cur_room = get_room_containing_pt(person.pos);}
 
 	// check for steam damage; only zombies should get here
-	if (in_ext_basement && has_room_geom() && interior->room_geom->particle_manager.get_closest_particle(new_pos, coll_dist, pz1, pz2, PART_EFFECT_STEAM)) {
+	if (in_ext_basement && has_room_geom() && tfticks >= interior->next_steam_hurt_time &&
+		interior->room_geom->particle_manager.get_closest_particle(new_pos, coll_dist, pz1, pz2, PART_EFFECT_STEAM))
+	{
+		interior->next_steam_hurt_time = tfticks + double(rgen.rand_uniform(1.0, 1.5))*TICKS_PER_SECOND; // play less frequently since steam damage is continuous
 		building_person_hurt_sound(person_ix, 1); // is_steam=1
 	}
 	// create splashes if just fell in the pool, or if head is above the water
@@ -3486,7 +3586,7 @@ struct poi_cache_t {
 		return 1;
 	}
 };
-poi_cache_t poi_cache;
+thread_local poi_cache_t poi_cache; // per-thread since buildings are updated in parallel
 
 bool building_t::select_person_poi(unsigned room_id, float radius, point &pos, rand_gen_t &rgen) const {
 	// some other ideas: select least used or least recently used POI? use sink after toilet in bathroom? return false sometimes if there's only one?
@@ -3572,10 +3672,39 @@ void building_t::move_person_to_not_collide(person_t &person, person_t const &ot
 // Note: non-const because this updates room lights
 void vect_building_t::ai_room_update(float delta_dir, float dmax, point const &camera_bs, rand_gen_t &rgen) {
 	//timer_t timer("Building People Update"); // 0.25ms, mostly iteration overhead, for sparse update with 2-6 people per building (avg for 2 calls city + secondary)
+	struct bldg_update_t {
+		unsigned bix=0;
+		bool serial=0;
+		rand_gen_t rgen;
+		vector<deferred_sound_t> sounds;
+	};
+	vector<bldg_update_t> updates;
+	unsigned num_par(0);
 
 	for (iterator b = begin(); b != end(); ++b) {
 		if (!b->has_people() || !b->bcube.closest_dist_less_than(camera_bs, dmax)) continue; // no people or too far away, no updates
-		b->all_ai_room_update(rgen, delta_dir);
+		updates.emplace_back();
+		bldg_update_t &u(updates.back());
+		u.bix = (b - begin());
+		// the player's building and connected buildings can interact with the player and other global state, so they're updated serially
+		u.serial = (&(*b) == player_building || b->interior->conn_info);
+		u.rgen.set_state(rgen.rand(), (u.bix + 1)); // each building has its own RNG stream, seeded in building order, so that results don't depend on threads
+		u.rgen.rand_mix();
+		num_par += !u.serial;
+	}
+	// buildings don't share AI state, so they can be updated in parallel; sounds are queued and played in building order
+#pragma omp parallel for schedule(dynamic,1) if (num_par > 1)
+	for (int i = 0; i < (int)updates.size(); ++i) {
+		bldg_update_t &u(updates[i]);
+		if (u.serial) continue;
+		set_deferred_sounds_for_thread(&u.sounds);
+		operator[](u.bix).all_ai_room_update(u.rgen, delta_dir);
+		set_deferred_sounds_for_thread(nullptr);
+	}
+	for (bldg_update_t const &u : updates) {play_deferred_sounds(u.sounds);}
+
+	for (bldg_update_t &u : updates) {
+		if (u.serial) {operator[](u.bix).all_ai_room_update(u.rgen, delta_dir);}
 	}
 }
 
@@ -3654,12 +3783,6 @@ int building_t::room_or_adj_room_has_stairs(int room_ix, float zval, bool inc_ad
 }
 
 void building_t::building_person_hurt_sound(unsigned person_ix, bool is_steam) const {
-	if (is_steam) { // play less frequently since steam damage is continuous
-		static double next_time(0.0);
-		static rand_gen_t rgen;
-		if (tfticks < next_time) return; // too soon
-		next_time = tfticks + double(rgen.rand_uniform(1.0, 1.5))*TICKS_PER_SECOND; 
-	}
 	person_t &person(interior->people[person_ix]);
 	if (in_building_gameplay_mode()) {maybe_play_zombie_sound(person.pos, person_ix, !is_steam, 1, 1.0, 1.25);} // zombie
 	else {gen_sound_thread_safe((person.is_female ? SOUND_SCREAM3 : SOUND_SCREAM1), (person.pos + get_camera_coord_space_xlate()), 1.0, 1.0, 1.0, is_steam);} // human
@@ -2537,24 +2537,49 @@ bool building_t::check_cube_on_or_near_stairs(cube_t const &c) const {
 	return 0;
 }
 
+// placement collision classes for overlaps_other_room_obj(), by object type
+enum {PCOLL_NONE=0, PCOLL_SKIP=1, PCOLL_INC_ADJ=2, PCOLL_ALWAYS=4, PCOLL_DRINK=8, PCOLL_DESK=16, PCOLL_BOOK=32};
+
+class placement_coll_table_t {
+	uint8_t flags[NUM_ROBJ_TYPES] = {};
+public:
+	placement_coll_table_t() {
+		flags[TYPE_POOL_TILE] = PCOLL_SKIP; // always excluded, since it's thin and objects can be mounted over it
+		// Note: light switches/outlets/vents/pipes/TVs/monitors don't collide with the player or AI, but they collide with other placed objects to avoid blocking them;
+		// however, it's okay to block outlets with furniture
+		for (room_object type : {TYPE_SWITCH, TYPE_OUTLET, TYPE_VENT}) {flags[type] = PCOLL_INC_ADJ;} // inc adj as these objects may shrink to zero area far from origin
+		for (room_object type : {TYPE_PIPE, TYPE_FALSE_DOOR, TYPE_FIRE_EXT, TYPE_TV, TYPE_MONITOR, TYPE_US_FLAG, TYPE_CLOCK, TYPE_SHOE, TYPE_FISHTANK, TYPE_PET_CAGE}) {
+			flags[type] = PCOLL_ALWAYS;
+		}
+		flags[TYPE_BOTTLE] = flags[TYPE_DRINK_CAN] = PCOLL_DRINK;
+		flags[TYPE_DESK] = PCOLL_DESK;
+		flags[TYPE_BOOK] = PCOLL_BOOK;
+	}
+	uint8_t get(room_object type) const {assert(type < NUM_ROBJ_TYPES); return flags[type];}
+};
+
 // Note: for procedural object placement; no expanded_objs, but includes blockers
 bool building_t::overlaps_other_room_obj(cube_t const &c, unsigned objs_start, bool check_all, unsigned const *objs_end) const {
 	assert(has_room_geom());
+	static placement_coll_table_t const coll_table;
 	vect_room_object_t &objs(interior->room_geom->objs);
 	auto start(objs.begin()+objs_start), end((objs_end == nullptr) ? objs.end() : (objs.begin()+*objs_end));
 	assert(objs_start <= objs.size() && start <= end);
 
 	for (auto i = start; i != end; ++i) {
-		room_object const type(i->type);
-		if (type == TYPE_POOL_TILE) continue; // always excluded, since it's thin and objects can be mounted over it
-		if (i->is_a_drink() && i->is_on_floor() && i->intersects_no_adj(c)) return 1; // bottles and cans on the floor do count
-		// Note: light switches/outlets/vents/pipes/TVs/monitors don't collide with the player or AI, but they collide with other placed objects to avoid blocking them;
-		// however, it's okay to block outlets with furniture
-		if ((type == TYPE_SWITCH || type == TYPE_OUTLET || type == TYPE_VENT) && i->intersects(c)) return 1; // inc adj as these objects may shrink to zero area far from origin
-		if ((check_all || !i->no_coll() || type == TYPE_PIPE || type == TYPE_FALSE_DOOR || type == TYPE_FIRE_EXT || type == TYPE_TV || type == TYPE_MONITOR ||
-			type == TYPE_US_FLAG || type == TYPE_CLOCK || type == TYPE_SHOE || i->is_pet_container()) && i->intersects_no_adj(c)) return 1;
-		if (type == TYPE_DESK && i->shape == SHAPE_TALL && i->intersects_xy_no_adj(c) && c.intersects_no_adj(get_desk_top_back(*i))) return 1; // check tall desk back
-		if (type == TYPE_BOOK && (i->flags & RO_FLAG_ON_FLOOR) && i->intersects_no_adj(c)) return 1; // books on floors count
+		if (!i->intersects_xy(c)) continue; // early reject; all tests below require an XY overlap
+		uint8_t const pflags(coll_table.get(i->type));
+
+		if (pflags == PCOLL_NONE) { // common case
+			if ((check_all || !i->no_coll()) && i->intersects_no_adj(c)) return 1;
+			continue;
+		}
+		if (pflags & PCOLL_SKIP) continue;
+		if ((pflags & PCOLL_DRINK) && i->is_on_floor() && i->intersects_no_adj(c)) return 1; // bottles and cans on the floor do count
+		if ((pflags & PCOLL_INC_ADJ) && i->intersects(c)) return 1;
+		if ((check_all || !i->no_coll() || (pflags & PCOLL_ALWAYS)) && i->intersects_no_adj(c)) return 1;
+		if ((pflags & PCOLL_DESK) && i->shape == SHAPE_TALL && i->intersects_xy_no_adj(c) && c.intersects_no_adj(get_desk_top_back(*i))) return 1; // check tall desk back
+		if ((pflags & PCOLL_BOOK) && (i->flags & RO_FLAG_ON_FLOOR) && i->intersects_no_adj(c)) return 1; // books on floors count
 	} // for i
 	return 0;
 }
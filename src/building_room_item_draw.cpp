@@ -471,6 +471,7 @@ void building_room_geom_t::clear() {
 	clear_materials();
 	objs.clear();
 	light_bcubes.clear();
+	light_vis_cache.clear();
 }
 void building_room_geom_t::clear_materials() { // clears material VBOs
 	mats_static .clear();
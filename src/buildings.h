@@ -738,6 +738,22 @@ struct path_node_t : public point {
 	path_node_t(point const &p, unsigned rid) : point(p), room_id(rid) {}
 };
 
+// room light occlusion query results, reused across frames; stored as parallel arrays indexed by light object index
+struct light_vis_cache_t {
+	// visible results are reused while the camera stays in the same cell and floor (conservative); occluded results only while the camera is stationary
+	static unsigned const KEY_LEN = 6;
+	unsigned cell_epoch=1, pos_epoch=1, key[KEY_LEN]={}; // key: {cell x, cell y, floor, door state version, num objects, camera/player flags}
+	point camera_pos;
+	vect_cube_t query_cubes;
+	vector<unsigned> vis_epoch, occ_epoch; // cell_epoch when found visible, pos_epoch when found occluded
+	vector<uint8_t> query_flags;
+
+	void clear() {query_cubes.clear(); vis_epoch.clear(); occ_epoch.clear(); query_flags.clear(); ++cell_epoch; ++pos_epoch;}
+	void begin_frame(point const &camera_bs, unsigned const new_key[KEY_LEN], unsigned num_objs);
+	int  lookup(unsigned ix, cube_t const &c, uint8_t flags) const; // returns 1=occluded, 0=visible, -1=unknown
+	void store (unsigned ix, cube_t const &c, uint8_t flags, bool occluded);
+};
+
 struct particle_source_t {
 	point pos;
 	vector3d velocity;
@@ -782,6 +798,7 @@ struct building_room_geom_t {
 		mats_doors, mats_exterior, mats_ext_detail;
 	rgeom_mat_t mats_glass[2]; // {viewed from below, viewed from above}
 	vect_cube_t light_bcubes, shelf_rack_occluders[2], glass_floors, jails; // shelf_rack_occluders: {back, top}
+	light_vis_cache_t light_vis_cache;
 	vect_cube_t pgbr_walls[2]; // parking garage and backrooms walls, in each dim
 	vector<index_pair_t> pgbr_wall_ixs; // indexes into pgbr_walls
 	building_decal_manager_t decal_manager;
@@ -1570,6 +1587,7 @@ struct building_interior_t {
 	uint64_t room_type_count=0; // currently only used for prisons
 	unsigned extb_walls_start[2]={}, mall_hall_walls_start[2]={};
 	unsigned gen_room_details_pass=0, rgen_seed_ix=0, backrooms_tid=0, room_geom_rseed=0;
+	unsigned door_state_version=0; // incremented when a door or mall gate changes in a way that can affect AI path finding
 	int garage_room=-1, ext_basement_hallway_room_id=-1, ext_basement_door_stack_ix=-1, last_active_door_ix=-1, security_room_ix=-1;
 	uint8_t furnace_type=FTYPE_NONE, attic_type=ATTIC_TYPE_RAFTERS, restaurant_orient=0;
 	bool door_state_updated=0, is_unconnected=0, ignore_ramp_placement=0, placed_people=0, elevators_disabled=0, attic_access_open=0, has_backrooms=0;
@@ -1577,8 +1595,17 @@ struct building_interior_t {
 	uint8_t num_extb_floors=0; // for malls and backrooms
 	float water_zval=0.0; // for multilevel backrooms and swimming pools
 	float int_door_width=0.0;
+	double next_steam_hurt_time=0.0; // per-building so that AI updates are independent of other buildings and threads
 	//vect_room_object_t prev_objs; vector<room_t> prev_rooms; // used for debugging
 
+	struct room_door_stacks_cache_t { // door stacks near the most recently queried room, for object placement
+		cube_t room;
+		float door_width=0.0;
+		unsigned num_door_stacks=0;
+		vector<unsigned> ds_ixs;
+	};
+	mutable room_door_stacks_cache_t room_ds_cache;
+
 	building_interior_t();
 	~building_interior_t();
 	float get_doorway_width() const;
@@ -1595,6 +1622,7 @@ struct building_interior_t {
 	int get_store_id_for_room(unsigned room_id) const;
 	bool obj_on_restaurant_counter(room_object_t const &obj) const;
 	bool is_cube_close_to_doorway(cube_t const &c, cube_t const &room, float dmin=0.0f, bool inc_open=0, bool check_open_dir=0) const;
+	bool is_cube_close_to_open_wall(cube_t const &c, float door_width) const;
 	bool is_blocked_by_stairs_or_elevator(cube_t const &c, float dmin=0.0f, bool elevators_only=0, int no_check_enter_exit=0) const;
 	void get_stairs_and_elevators_bcubes_intersecting_cube(cube_t const &c, vect_cube_t &bcubes, float ends_clearance=0.0, float sides_clearance=0.0) const;
 	void sort_for_optimal_culling();
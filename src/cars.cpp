@@ -787,7 +787,7 @@ void car_draw_state_t::draw_car(car_t const &car, bool is_dlight_shadows, int di
 	float const dist_val(p2p_dist(camera_pdu.pos, center_xlated)/draw_tile_dist);
 	bool const draw_model(car_model_loader.num_models() > 0 &&
 		(is_dlight_shadows ? dist_less_than(pre_smap_player_pos, center, 0.05*draw_tile_dist) : (shadow_only || dist_val < 0.05)) &&
-		car_model_loader.is_model_valid(car.model_id));
+		car_model_loader.is_model_ready(car.model_id, p2p_dist_sq(camera_pdu.pos, center_xlated)));
 	if (draw_model && is_occluded(car.bcube)) return; // only check occlusion for expensive car models
 	uint64_t const tile_id(get_tile_id_containing_point_no_xyoff(center_xlated));
 		
@@ -67,7 +67,7 @@ struct city_params_t {
 	// cars
 	unsigned num_cars=0;
 	float car_speed=0.0, traffic_balance_val=0.5, new_city_prob=1.0, max_car_scale=1.0;
-	bool enable_car_path_finding=0, convert_model_files=0, cars_use_driveways=0;
+	bool enable_car_path_finding=0, convert_model_files=0, cars_use_driveways=0, async_model_loading=0;
 	vector<city_model_t> car_model_files, ped_model_files, hc_model_files;
 	// parking lots
 	unsigned min_park_spaces=12, min_park_rows=1;
@@ -884,6 +884,7 @@ public:
 	void draw_car_in_pspace(car_t &car, shader_t &s, vector3d const &xlate, bool shadow_only, unsigned btype);
 	void add_car_headlights(vector3d const &xlate, cube_t &lights_bcube) {dstate.add_car_headlights(cars, xlate, lights_bcube);}
 	void free_context() {car_model_loader.free_context(); helicopter_model_loader.free_context();}
+	void update_async_model_loads() {car_model_loader.update_async_loads(); helicopter_model_loader.update_async_loads();}
 }; // car_manager_t
 
 
@@ -1020,6 +1021,7 @@ public:
 	bool is_player_model_female();
 	void draw_player_model(shader_t &s, vector3d const &xlate, bool shadow_only);
 	void free_context() {ped_model_loader.free_context();}
+	void update_async_model_loads() {ped_model_loader.update_async_loads();}
 }; // end ped_manager_t
 
 
@@ -44,6 +44,7 @@ void city_params_t::init_kw_maps() {
 	kwmb.add("assign_house_plots",     assign_house_plots);
 	kwmb.add("new_city_conn_road_alg", new_city_conn_road_alg);
 	kwmb.add("convert_model_files",    convert_model_files); // to model3d format; applies to cars, people, building items, etc.
+	kwmb.add("async_model_loading",    async_model_loading); // load car and people models on a background thread the first time they're drawn
 	kwmr.add("road_width",   road_width,   FP_CHECK_NONNEG);
 	kwmr.add("road_spacing", road_spacing, FP_CHECK_NONNEG);
 	kwmr.add("road_spacing_rand",   road_spacing_rand,   FP_CHECK_NONNEG);
@@ -483,17 +483,22 @@ class road_network_t : public streetlights_t { // AKA city center
 	template<typename T> void add_tile_blocks(vector<T> &v, map<uint64_t, unsigned> &tile_to_block_map, unsigned type_ix) {
 		assert(type_ix < NUM_RD_TYPES);
 		sort(v.begin(), v.end(), cmp_by_tile());
+		uint64_t prev_tile_id(0);
+		unsigned block_id(0);
 
 		for (unsigned i = 0; i < v.size(); ++i) {
 			uint64_t const tile_id(get_tile_id_for_cube(v[i]));
-			auto it(tile_to_block_map.find(tile_id));
-			unsigned block_id(0);
-			
-			if (it == tile_to_block_map.end()) { // not found, add new block
-				tile_to_block_map[tile_id] = block_id = tile_blocks.size();
-				tile_blocks.push_back(tile_block_t(v[i]));
+
+			if (i == 0 || tile_id != prev_tile_id) { // sorted by tile, so only look up the block when the tile changes
+				auto it(tile_to_block_map.find(tile_id));
+
+				if (it == tile_to_block_map.end()) { // not found, add new block
+					tile_to_block_map[tile_id] = block_id = tile_blocks.size();
+					tile_blocks.push_back(tile_block_t(v[i]));
+				}
+				else {block_id = it->second;}
+				prev_tile_id = tile_id;
 			}
-			else {block_id = it->second;}
 			assert(block_id < tile_blocks.size());
 			tile_blocks[block_id].ranges[type_ix].update(i);
 			tile_blocks[block_id].bcube.union_with_cube(v[i]);
@@ -1171,19 +1176,21 @@ public:
 		for (unsigned i = 0; i < 3; ++i) {add_tile_blocks(isecs[i], tile_to_block_map, (TYPE_ISEC2 + i));}
 		plot_xy.gen_adj_plots(plots);
 	}
-	void gen_parking_lots_and_place_objects(vector<car_t> &cars, bool have_cars, bool &have_plot_dividers) {
+	void gen_parking_lots_and_place_objects(vector<car_t> &cars, bool have_cars) {
 		city_obj_placer = city_obj_placer_t(); // clear; should be empty anyway, since city_obj_placer is not reused
 		city_obj_placer.set_plot_subdiv_sz(get_plot_subdiv_sz());
 		city_obj_placer.add_city_ug_elevator_entrances(uges); // Note: can clear ug_elev_entrances after this, but it's not needed
 		city_obj_placer.gen_parking_and_place_objects(plots, plot_colliders, cars, roads, isecs, bcube, plot_cuts, city_id, plot_id_offset,
 			have_cars, is_residential, !streetlights.empty());
+	}
+	bool finalize_placed_objects() { // only modifies data for this city, so can be called in parallel across cities; returns plot dividers flag
 		add_tile_blocks(city_obj_placer.parking_lots, tile_to_block_map, TYPE_PARK_LOT); // need to do this later, after gen_tile_blocks()
 		add_tile_blocks(city_obj_placer.driveways,    tile_to_block_map, TYPE_DRIVEWAY);
 		city_obj_placer.remap_parking_lot_ixs(); // required after sorting parking_lots
 		tile_to_block_map.clear(); // no longer needed
 		city_obj_placer.finalize_streetlights_power_grass_blockers(*this, plot_colliders);
 		for (vect_cube_t &c : plot_colliders) {sort(c.begin(), c.end(), [](cube_t const &a, cube_t const &b) {return (a.x1() < b.x1());});}
-		have_plot_dividers |= !city_obj_placer.has_plot_dividers();
+		return !city_obj_placer.has_plot_dividers();
 	}
 	void clear_old_building_data() {
 		plot_cuts.clear();
@@ -1376,7 +1383,7 @@ public:
 		uges.push_back(uge);
 		add_cube_to_plot_colliders(uge.entrance);
 	}
-	void add_cube_to_plot_colliders(cube_t const &c) { // Note: must be before plot_colliders sorting in gen_parking_lots_and_place_objects()
+	void add_cube_to_plot_colliders(cube_t const &c) { // Note: must be before plot_colliders sorting in finalize_placed_objects()
 		for (unsigned plot_ix = 0; plot_ix < plots.size(); ++plot_ix) {
 			if (!plots[plot_ix].intersects_xy(c)) continue;
 			plot_colliders[plot_ix].push_back(c); // or insert in the correct place?
@@ -3006,7 +3013,9 @@ public:
 		} // for p
 	}
 	void connect_power_poles_to_transmission_lines() {
-		for (auto &t : transmission_lines) {
+#pragma omp parallel for schedule(dynamic,1)
+		for (int i = 0; i < (int)transmission_lines.size(); ++i) { // each line only reads the power poles of its two cities
+			transmission_line_t &t(transmission_lines[i]);
 			closest_edge_power_pole_conn_pts(t.p1, t.city1, t.p1_wire_pts);
 			closest_edge_power_pole_conn_pts(t.p2, t.city2, t.p2_wire_pts);
 			t.calc_bcube();
@@ -3039,13 +3048,19 @@ public:
 	void gen_tile_blocks() {
 		timer_t timer("Gen Tile Blocks");
 		global_rn.gen_tile_blocks(); // must be done first to fill in road_to_city and city_to_seg
-		for (auto i = road_networks.begin(); i != road_networks.end(); ++i) {i->gen_tile_blocks();}
+#pragma omp parallel for schedule(dynamic,1)
+		for (int i = 0; i < (int)road_networks.size(); ++i) {road_networks[i].gen_tile_blocks();} // independent per city
 		unsigned global_plot_id(0);
 		global_rn.calc_ix_values(road_networks, global_rn, global_plot_id);
 		for (auto i = road_networks.begin(); i != road_networks.end(); ++i) {i->calc_ix_values(road_networks, global_rn, global_plot_id);}
 	}
 	void gen_parking_lots_and_place_objects(vector<car_t> &cars, bool have_cars) {
-		for (auto i = road_networks.begin(); i != road_networks.end(); ++i) {i->gen_parking_lots_and_place_objects(cars, have_cars, have_plot_dividers);}
+		// object placement queries and modifies buildings, trees, and the shared cars vector, so it must be done serially in city order
+		for (auto i = road_networks.begin(); i != road_networks.end(); ++i) {i->gen_parking_lots_and_place_objects(cars, have_cars);}
+		vector<unsigned char> plot_dividers(road_networks.size(), 0);
+#pragma omp parallel for schedule(dynamic,1)
+		for (int i = 0; i < (int)road_networks.size(); ++i) {plot_dividers[i] = road_networks[i].finalize_placed_objects();}
+		for (unsigned char v : plot_dividers) {have_plot_dividers |= bool(v);}
 	}
 	void clear_old_building_data() {
 		for (auto i = road_networks.begin(); i != road_networks.end(); ++i) {i->clear_old_building_data();}
@@ -3609,6 +3624,7 @@ public:
 		cube_t cities_bcube;
 		{ // open a scope
 			timer_t t("Choose City Location");
+			// serial: each city flattens the heightmap used to choose the next location, and city IDs (used as RNG seeds) depend on earlier failures
 			for (unsigned n = 0; n < city_params.num_cities; ++n) {gen_city(city_params, cities_bcube);}
 		}
 		if (!cities_bcube.is_all_zeros()) {set_buildings_pos_range(cities_bcube);}
@@ -3714,6 +3730,10 @@ public:
 		}
 	}
 	void draw(int shadow_only, int reflection_pass, int trans_op_mask, vector3d const &xlate) { // shadow_only: 0=non-shadow pass, 1=sun/moon shadow, 2=dynamic shadow
+		if (!shadow_only && !reflection_pass && (trans_op_mask & 1)) { // once per frame, before any early returns
+			car_manager.update_async_model_loads();
+			ped_manager.update_async_model_loads();
+		}
 		// if player is fully in the basement, not on stairs, don't draw anything; query building for skylight if in mall
 		if (player_in_basement >= 2 && (reflection_pass || !player_in_mall)) return;
 		if (player_cant_see_outside_building()) return; // player can't see outside the building (in ext basement, parking garage, attic, or windowless building)
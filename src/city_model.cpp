@@ -4,10 +4,16 @@
 #include "city.h"
 #include "file_utils.h"
 #include "format_text.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 
+extern bool no_store_model_textures_in_memory;
 extern city_params_t city_params;
 
 bool read_assimp_model(string const &filename, model3d &model, geom_xform_t const &xf, string const &anim_name, int recalc_normals, bool verbose);
+void mark_as_background_thread();
 
 
 bool read_keyword(FILE *fp, string &str) {
@@ -133,12 +139,59 @@ bool city_model_loader_t::model_filename_contains(unsigned id, string const &str
 }
 bool city_model_loader_t::is_model_valid(unsigned id) {
 	city_model_t &model(get_model(id));
-	if (!model.tried_to_load) {load_model_id(id);} // load the model if needed
+	if (!model.tried_to_load) {load_model_id(id);} // load the model if needed; waits for any pending async load
 	return model.is_loaded();
 }
+bool city_model_loader_t::is_model_ready(unsigned id, float dist_sq) { // non-blocking version of is_model_valid() for drawing; dist_sq is used for load priority
+	city_model_t const &model(get_model(id));
+	if (model.tried_to_load) return model.is_loaded();
+	// async loading requires textures to be kept in CPU memory until they're sent to the GPU on the main thread
+	if (!city_params.async_model_loading || no_store_model_textures_in_memory) return is_model_valid(id);
+	if (can_skip_model(id)) return 0;
+	request_async_load(id, dist_sq);
+	return 0; // caller should draw a placeholder until the load has finished
+}
+
+bool read_city_model_file(city_model_t const &model, model3d &cur_model, texture_manager &tmgr, bool verbose) { // may be called on a background thread
+	if (load_model_file_into(model.fn, cur_model, geom_xform_t(), model.default_anim_name, model.recalc_normals,
+		city_params.convert_model_files, verbose, model.rev_winding_mask) != 1) return 0; // treat model3d write failure as an error as well
+	if (!model.allow_emissive) {cur_model.clear_emissive_colors();} // nothing should be emissive
+
+	for (city_model_t::model_anim_t const &anim : model.anim_fns) {
+		model3d anim_data(anim.fn, tmgr); // Note: texture manager is passed in, even though there should be no loaded textures; however, this isn't checked
+			
+		if (!read_assimp_model(anim.fn, anim_data, geom_xform_t(), anim.anim_name, model.recalc_normals, verbose)) {
+			cerr << format_red("Error: Failed to read model animation file '" + anim.fn + "'; Skipping this animation") << endl;
+		}
+		else {cur_model.merge_animation_from(anim_data);}
+	} // for anim
+	return 1;
+}
+
+void city_model_loader_t::finalize_sub_model(city_model_t &model, bool success) { // main thread only
+	model.tried_to_load = 1; // flag, even if load fails
+	model.load_pending  = 0;
+
+	if (!success) {
+		cerr << format_red("Error: Failed to read model file '" + model.fn + "'; Skipping this model");
+		if (has_low_poly_model()) {cerr << " (will use default low poly model)";}
+		cerr << "." << endl;
+		model.model3d_id = -1; // invalid
+		return;
+	}
+	model3d const &cur_model(get_model3d_by_ix(model.model3d_id));
+
+	if (model.shadow_mat_ids.empty()) { // empty shadow_mat_ids, create the list from all materials
+		unsigned const num_materials(max(cur_model.num_materials(), size_t(1))); // max with 1 for unbound material
+		for (unsigned j = 0; j < num_materials; ++j) {model.shadow_mat_ids.push_back(j);} // add them all
+	}
+	city_params.any_model_has_animations |= cur_model.has_animations();
+}
 
 void city_model_loader_t::load_model_id(unsigned id) { // building objects, people, and cars
+	if (stream_state) {finish_async_load(id);} // if this model was requested for async load, complete the load now
 	unsigned const num_sub_models(get_num_sub_models(id));
+	bool any_loaded(0);
 
 	for (unsigned sm = 0; sm < num_sub_models; ++sm) { // load all sub-models
 		city_model_t &model(get_model(combine_model_submodel_id(id, sm)));
@@ -146,38 +199,221 @@ void city_model_loader_t::load_model_id(unsigned id) { // building objects, peop
 		if (can_skip_model(id) || model.fn.empty()) continue;
 		int const def_tid(-1); // should this be a model parameter?
 		colorRGBA const def_color(WHITE); // should this be a model parameter?
-		model.tried_to_load   = 1; // flag, even if load fails
-		model.model3d_id      = size(); // set before adding the model
-		bool const verbose    = 1;
 		float const lod_scale = 1.0; // or use model.lod_mult directly and not use it during drawing?
+		model.model3d_id = size(); // set before adding the model
+		push_back(model3d(model.fn, tmgr, def_tid, def_color, 0, 0.0, lod_scale, model.recalc_normals));
+		bool const success(read_city_model_file(model, back(), tmgr, 1)); // verbose=1
+		if (!success) {pop_back();}
+		finalize_sub_model(model, success);
+		any_loaded = 1;
+	} // for sm
+	if (any_loaded) {on_model_loaded(id);}
+}
+
+// async model streaming: file reading, parsing, and texture loading from disk are done on a background thread;
+// textures are compressed and sent to the GPU on the main thread in update_async_loads(), under a per-frame time budget
+struct model_load_job_t {
+	unsigned id=0;
+	float dist_sq=0.0; // distance to the camera; closest models are loaded first
+	texture_manager *tmgr=nullptr; // private to this job since texture_manager isn't thread safe
+	vector<unsigned> sm_ids; // combined model + sub-model IDs
+	vector<city_model_t> models; // copies for reading on the worker thread
+	vector<model3d *> dest; // allocated on the main thread; model3ds is a deque, so these pointers remain valid
+	vector<uint8_t> success;
+
+	void run() { // worker thread
+		success.resize(models.size(), 0);
+
+		for (unsigned i = 0; i < models.size(); ++i) {
+			if (!read_city_model_file(models[i], *dest[i], *tmgr, 0)) continue; // verbose=0 because we may be printing from multiple threads
+			dest[i]->load_all_used_tids(); // load textures from disk here; binding must be done later on the main thread
+			success[i] = 1;
+		}
+	}
+};
+
+struct model_stream_state_t {
+	std::mutex mutex;
+	std::condition_variable work_cv, done_cv;
+	map<unsigned, model_load_job_t> queued; // by model ID
+	set<unsigned> running;
+	vector<model_load_job_t> done;
+	deque<texture_manager> tmgrs; // deque so that pointers remain valid
+	bool exit_thread=0;
+	std::thread worker; // must be last so that all other members are constructed before the thread starts
+
+	model_stream_state_t() : worker([this]() {run();}) {}
 
-		if (!load_model_file(model.fn, *this, geom_xform_t(), model.default_anim_name, def_tid, def_color, 0, 0.0,
-			lod_scale, model.recalc_normals, 0, city_params.convert_model_files, verbose, model.rev_winding_mask))
+	~model_stream_state_t() {
 		{
-			cerr << format_red("Error: Failed to read model file '" + model.fn + "'; Skipping this model");
-			if (has_low_poly_model()) {cerr << " (will use default low poly model)";}
-			cerr << "." << endl;
-			model.model3d_id = -1; // invalid
-			continue;
+			std::lock_guard<std::mutex> lock(mutex);
+			exit_thread = 1;
 		}
-		assert(!empty()); // must have loaded a model
-		model3d &cur_model(back());
-		if (!model.allow_emissive) {cur_model.clear_emissive_colors();} // nothing should be emissive
+		work_cv.notify_all();
+		worker.join();
+	}
+	void run() {
+		mark_as_background_thread(); // so that texture code knows it can't make OpenGL calls
+		std::unique_lock<std::mutex> lock(mutex);
+
+		while (1) {
+			work_cv.wait(lock, [this]() {return (exit_thread || !queued.empty());});
+			if (exit_thread) break;
+			auto best(queued.begin());
+
+			for (auto i = queued.begin(); i != queued.end(); ++i) { // select the closest model; should be a small number of entries
+				if (i->second.dist_sq < best->second.dist_sq) {best = i;}
+			}
+			model_load_job_t job(std::move(best->second));
+			queued.erase(best);
+			running.insert(job.id);
+			lock.unlock();
+			job.run(); // this is the slow part, done without holding the lock
+			lock.lock();
+			running.erase(job.id);
+			done.push_back(std::move(job));
+			done_cv.notify_all();
+		} // end while
+	}
+	void wait_for_idle() {
+		std::unique_lock<std::mutex> lock(mutex);
+		done_cv.wait(lock, [this]() {return (queued.empty() && running.empty());});
+	}
+};
+
+city_model_loader_t:: city_model_loader_t() {}
+city_model_loader_t::~city_model_loader_t() {} // must be defined here, where model_stream_state_t is complete
 
-		if (model.shadow_mat_ids.empty()) { // empty shadow_mat_ids, create the list from all materials
-			unsigned const num_materials(max(cur_model.num_materials(), size_t(1))); // max with 1 for unbound material
-			for (unsigned j = 0; j < num_materials; ++j) {model.shadow_mat_ids.push_back(j);} // add them all
+model3d &city_model_loader_t::get_model3d_by_ix(int model3d_id) {
+	assert(model3d_id >= 0 && (size_t)model3d_id < size());
+	return operator[](model3d_id);
+}
+
+void city_model_loader_t::request_async_load(unsigned id, float dist_sq) { // main thread only
+	city_model_t &model(get_model(id));
+
+	if (model.load_pending) { // already requested; update priority if it hasn't been started yet
+		std::lock_guard<std::mutex> lock(stream_state->mutex);
+		auto it(stream_state->queued.find(id));
+		if (it != stream_state->queued.end()) {it->second.dist_sq = dist_sq;}
+		return;
+	}
+	unsigned const num_sub_models(get_num_sub_models(id));
+	vector<unsigned> sm_ids;
+
+	for (unsigned sm = 0; sm < num_sub_models; ++sm) {
+		unsigned const sm_id(combine_model_submodel_id(id, sm));
+		city_model_t const &sub_model(get_model(sm_id));
+		if (!sub_model.tried_to_load && !sub_model.load_pending && !sub_model.fn.empty()) {sm_ids.push_back(sm_id);}
+	}
+	if (sm_ids.empty()) {load_model_id(id); return;} // nothing to load, but we still need to mark the model as loaded
+	if (!stream_state) {stream_state.reset(new model_stream_state_t);}
+	model_load_job_t job;
+	job.id      = id;
+	job.dist_sq = dist_sq;
+	stream_state->tmgrs.emplace_back();
+	job.tmgr    = &stream_state->tmgrs.back();
+
+	for (unsigned sm_id : sm_ids) {
+		city_model_t &sub_model(get_model(sm_id));
+		float const lod_scale = 1.0;
+		sub_model.load_pending = 1;
+		sub_model.model3d_id   = size(); // set before adding the model
+		push_back(model3d(sub_model.fn, *job.tmgr, -1, WHITE, 0, 0.0, lod_scale, sub_model.recalc_normals));
+		job.sm_ids.push_back(sm_id);
+		job.models.push_back(sub_model);
+		job.dest.push_back(&back());
+	} // for sm
+	model.load_pending = 1; // mark the parent as well, in case it's not one of the sub-models
+	std::lock_guard<std::mutex> lock(stream_state->mutex);
+	stream_state->queued.emplace(id, std::move(job));
+	stream_state->work_cv.notify_one();
+}
+
+void city_model_loader_t::finalize_async_job(model_load_job_t &job) { // main thread only
+	for (unsigned i = 0; i < job.sm_ids.size(); ++i) {
+		city_model_t &model(get_model(job.sm_ids[i]));
+		if (job.success[i]) {job.dest[i]->bind_all_used_tids();} // texture compression and GPU upload
+		else {job.dest[i]->clear();} // leave the empty model in place so that indices of later models don't change
+		finalize_sub_model(model, job.success[i]);
+	}
+	get_model(job.id).load_pending = 0;
+	on_model_loaded(job.id);
+}
+
+void city_model_loader_t::finish_async_load(unsigned id) { // main thread only; blocks until this model is loaded
+	if (!get_model(id).load_pending) return;
+	assert(stream_state);
+	vector<model_load_job_t> to_finalize;
+	{
+		std::unique_lock<std::mutex> lock(stream_state->mutex);
+		auto it(stream_state->queued.find(id));
+
+		if (it != stream_state->queued.end()) { // not yet started; run it on this thread
+			model_load_job_t job(std::move(it->second));
+			stream_state->queued.erase(it);
+			lock.unlock();
+			job.run();
+			to_finalize.push_back(std::move(job));
 		}
-		for (city_model_t::model_anim_t const &anim : model.anim_fns) {
-			model3d anim_data(anim.fn, tmgr); // Note: texture manager is passed in, even though there should be no loaded textures; however, this isn't checked
+		else { // running or done; wait for the worker to finish it
+			stream_state->done_cv.wait(lock, [&]() {return !stream_state->running.count(id);});
 			
-			if (!read_assimp_model(anim.fn, anim_data, geom_xform_t(), anim.anim_name, model.recalc_normals, verbose)) {
-				cerr << format_red("Error: Failed to read model animation file '" + anim.fn + "'; Skipping this animation") << endl;
+			for (auto i = stream_state->done.begin(); i != stream_state->done.end(); ++i) {
+				if (i->id != id) continue;
+				to_finalize.push_back(std::move(*i));
+				stream_state->done.erase(i);
+				break;
 			}
-			else {cur_model.merge_animation_from(anim_data);}
-		} // for anim
-		city_params.any_model_has_animations |= cur_model.has_animations();
-	} // for sm
+		}
+	}
+	assert(to_finalize.size() == 1);
+	finalize_async_job(to_finalize.front());
+}
+
+void city_model_loader_t::update_async_loads() { // called once per frame on the main thread
+	if (!stream_state) return;
+	vector<model_load_job_t> to_finalize;
+	{
+		std::lock_guard<std::mutex> lock(stream_state->mutex);
+		if (stream_state->done.empty()) return;
+		to_finalize.swap(stream_state->done);
+	}
+	auto const start_time(std::chrono::steady_clock::now());
+	unsigned const max_time_ms = 4; // spread texture compression and upload across frames
+	unsigned num_done(0);
+
+	for (model_load_job_t &job : to_finalize) { // always finalize at least one model per frame
+		if (num_done > 0 && std::chrono::steady_clock::now() - start_time > std::chrono::milliseconds(max_time_ms)) break;
+		finalize_async_job(job);
+		++num_done;
+	}
+	if (num_done < to_finalize.size()) { // return remaining jobs to the done list for the next frame
+		std::lock_guard<std::mutex> lock(stream_state->mutex);
+		for (auto i = to_finalize.begin() + num_done; i != to_finalize.end(); ++i) {stream_state->done.push_back(std::move(*i));}
+	}
+}
+
+void city_model_loader_t::wait_for_async_loads() { // main thread only; finalizes all pending loads
+	if (!stream_state) return;
+	stream_state->wait_for_idle();
+	vector<model_load_job_t> to_finalize;
+	{
+		std::lock_guard<std::mutex> lock(stream_state->mutex);
+		to_finalize.swap(stream_state->done);
+	}
+	for (model_load_job_t &job : to_finalize) {finalize_async_job(job);}
+}
+
+void city_model_loader_t::clear() {
+	wait_for_async_loads();
+	model3ds::clear();
+	if (stream_state) {stream_state->tmgrs.clear();}
+}
+void city_model_loader_t::free_context() {
+	wait_for_async_loads(); // can't free models that are being loaded
+	model3ds::free_context();
+	if (stream_state) {for (texture_manager &t : stream_state->tmgrs) {t.free_tids();}}
 }
 
 bool object_model_loader_t::can_skip_model(unsigned id) const {
@@ -370,8 +606,7 @@ unsigned car_model_loader_t       ::num_models() const {return city_params.car_m
 unsigned helicopter_model_loader_t::num_models() const {return city_params.hc_model_files .size();}
 unsigned object_model_loader_t    ::num_models() const {return NUM_OBJ_MODELS;}
 
-void car_model_loader_t::load_model_id(unsigned id) {
-	city_model_loader_t::load_model_id(id);
+void car_model_loader_t::on_model_loaded(unsigned id) {
 	string const &fn(get_model(id).fn);
 	// the best we can do is to search for the string 'police' and 'ambulance' in the filename
 	if      (string_find(fn, "Police"   ) || string_find(fn, "police"   )) {police_model_id = id;}
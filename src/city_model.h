@@ -39,7 +39,7 @@ struct animation_state_t {
 struct city_model_t {
 
 	string fn;
-	bool valid=0, swap_xz=0, swap_yz=1, two_sided=0, allow_emissive=0, mirrored=0, is_zombie=0, tried_to_load=0;
+	bool valid=0, swap_xz=0, swap_yz=1, two_sided=0, allow_emissive=0, mirrored=0, is_zombie=0, tried_to_load=0, load_pending=0; // load_pending is for async loads
 	int body_mat_id=-1, fixed_color_id=-1, recalc_normals=1, centered=0; // recalc_normals: 0=no, 1=yes, 2=face_weight_avg
 	int blade_mat_id=-1; // for helicopters
 	int model3d_id=-1; // index into model3ds vector; -1 is not set
@@ -60,18 +60,30 @@ struct city_model_t {
 	city_model_t() {}
 	city_model_t(string const &fn_, int bmid, int fcid, float rot, float dz_, float lm, vector<unsigned> const &smids) :
 		fn(fn_), body_mat_id(bmid), fixed_color_id(fcid), xy_rot(rot), lod_mult(lm), shadow_mat_ids(smids) {}
-	bool is_loaded() const {return (model3d_id >= 0);}
+	bool is_loaded() const {return (model3d_id >= 0 && !load_pending);}
 	bool read(FILE *fp, bool is_helicopter=0, bool is_person=0);
 	bool check_filename();
 	bool has_animation(string const &anim_name) const;
 };
 
 
+struct model_stream_state_t; // defined in city_model.cpp
+struct model_load_job_t;
+
 class city_model_loader_t : public model3ds {
+	std::unique_ptr<model_stream_state_t> stream_state; // allocated on first async load request
+
+	void request_async_load(unsigned id, float dist_sq);
+	void finish_async_load(unsigned id);
+	void finalize_async_job(model_load_job_t &job);
+	void finalize_sub_model(city_model_t &model, bool success);
+	model3d &get_model3d_by_ix(int model3d_id);
 protected:
 	model3d &get_model3d(unsigned id);
+	virtual void on_model_loaded(unsigned id) {}
 public:
-	virtual ~city_model_loader_t() {}
+	city_model_loader_t();
+	virtual ~city_model_loader_t();
 	virtual bool has_low_poly_model() {return 0;}
 	virtual bool can_skip_model(unsigned id) const {return 0;}
 	virtual unsigned num_models() const = 0;
@@ -83,7 +95,12 @@ public:
 	colorRGBA get_avg_color(unsigned id, bool area_weighted=1);
 	bool model_filename_contains(unsigned id, string const &str, string const &str2="") const;
 	bool is_model_valid(unsigned id);
-	virtual void load_model_id(unsigned id);
+	bool is_model_ready(unsigned id, float dist_sq);
+	void load_model_id(unsigned id);
+	void update_async_loads();
+	void wait_for_async_loads();
+	void clear();
+	void free_context();
 	bool check_anim_wrapped(unsigned model_id, unsigned model_anim_id, float old_time, float new_time);
 	float get_anim_duration(unsigned model_id, unsigned model_anim_id);
 	void draw_model(shader_t &s, vector3d const &pos, cube_t const &obj_bcube, vector3d const &dir, colorRGBA const &color, vector3d const &xlate, unsigned model_id,
@@ -98,7 +115,7 @@ class car_model_loader_t : public city_model_loader_t {
 public:
 	int police_model_id=-1, amb_model_id=-1, bus_model_id=-1;
 	virtual bool has_low_poly_model() {return 1;}
-	virtual void load_model_id(unsigned id);
+	virtual void on_model_loaded(unsigned id);
 	virtual unsigned num_models() const;
 	virtual city_model_t const &get_model(unsigned id) const;
 	virtual city_model_t       &get_model(unsigned id);
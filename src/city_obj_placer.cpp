@@ -5,6 +5,7 @@
 #include "city_objects.h"
 #include "tree_3dw.h" // for tree_placer_t
 #include "buildings.h"
+#include <functional>
 
 
 float pond_max_depth(0.0);
@@ -522,7 +523,7 @@ int city_obj_placer_t::select_dest_parking_space(unsigned driveway_ix, bool allo
 	return sel_space;
 }
 
-bool check_pt_and_place_blocker(point const &pos, vect_cube_t &blockers, float radius, float blocker_spacing, bool add_blocker=1) {
+bool check_pt_and_place_blocker(point const &pos, placement_blockers_t &blockers, float radius, float blocker_spacing, bool add_blocker=1) {
 	cube_t bc(pos);
 	if (has_bcube_int_xy(bc, blockers, radius)) return 0; // intersects a building, parking lot, or other object - skip
 	if (!add_blocker) return 1;
@@ -530,7 +531,7 @@ bool check_pt_and_place_blocker(point const &pos, vect_cube_t &blockers, float r
 	blockers.push_back(bc); // prevent trees and benches from being too close to each other
 	return 1;
 }
-bool try_place_obj(cube_t const &plot, vect_cube_t &blockers, rand_gen_t &rgen, float radius, float blocker_spacing, unsigned num_tries, point &pos, bool add_blocker) {
+bool try_place_obj(cube_t const &plot, placement_blockers_t &blockers, rand_gen_t &rgen, float radius, float blocker_spacing, unsigned num_tries, point &pos, bool add_blocker) {
 	for (unsigned t = 0; t < num_tries; ++t) {
 		pos = gen_xy_pos_in_area(plot, radius, rgen, plot.z1());
 		if (check_pt_and_place_blocker(pos, blockers, radius, blocker_spacing, add_blocker)) return 1; // success
@@ -548,8 +549,9 @@ void place_tree(point const &pos, float radius, int ttype, vect_cube_t &collider
 	colliders.push_back(bcube);
 	if (tree_pos != nullptr) {tree_pos->push_back(pos);}
 }
-void resize_blockers_for_trees(vect_cube_t &blockers, unsigned six, unsigned eix, float resize_amt) {
+void resize_blockers_for_trees(placement_blockers_t &blockers, unsigned six, unsigned eix, float resize_amt) {
 	float const height_thresh(1.5*city_params.get_nom_car_size().z);
+	blockers.update_index(); // index at the original size before shrinking so that the index is still valid after the undo expand
 
 	for (auto i = blockers.begin()+six; i != blockers.begin()+eix; ++i) {
 		float const resize_scale((i->dz() < height_thresh) ? 1.0 : 0.5); // reduced shrink for tall objects such as fences and walls since trees may clip through them
@@ -571,7 +573,7 @@ bool city_obj_placer_t::check_walkway_coll_xy(point const &pos, float radius) co
 	return (intersects_city_obj_xy(test_cube, walkways) || intersects_city_obj_xy(test_cube, elevators));
 }
 
-void city_obj_placer_t::place_trees_in_plot(road_plot_t const &plot, vect_cube_t &blockers, vect_cube_t &colliders,
+void city_obj_placer_t::place_trees_in_plot(road_plot_t const &plot, placement_blockers_t &blockers, vect_cube_t &colliders,
 	vector<point> &tree_pos, vect_cube_t const &plot_cuts, rand_gen_t &rgen, unsigned buildings_end)
 {
 	if (city_params.max_trees_per_plot == 0) return;
@@ -625,11 +627,11 @@ void city_obj_placer_t::place_trees_in_plot(road_plot_t const &plot, vect_cube_t
 
 void city_obj_groups_t::clear() {
 	vector<cube_with_ix_t>::clear();
-	by_tile.clear();
+	tile_ixs.clear();
 	bcube.set_to_zeros();
 }
 void city_obj_groups_t::insert_obj_ix(cube_t const &c, unsigned ix) {
-	by_tile[get_tile_id_for_cube(c)].push_back(ix);
+	tile_ixs.emplace_back(get_tile_id_for_cube(c), ix);
 }
 template<typename T> void city_obj_groups_t::add_obj(T const &obj, vector<T> &objs) {
 	insert_obj_ix(obj.bcube, objs.size());
@@ -640,16 +642,32 @@ template<typename T> void city_obj_groups_t::create_groups(vector<T> &objs, cube
 	bcube.set_to_zeros();
 	vector<T> new_objs;
 	new_objs.reserve(objs.size());
-	reserve(by_tile.size()); // the number of actual groups
-
-	for (auto g = by_tile.begin(); g != by_tile.end(); ++g) {
+	// bucket object indices by tile with a stable counting sort: groups are in increasing tile_id order, objects within a group in insertion order
+	vector<uint64_t> tile_ids;
+	tile_ids.reserve(tile_ixs.size());
+	for (auto const &t : tile_ixs) {tile_ids.push_back(t.first);}
+	sort(tile_ids.begin(), tile_ids.end());
+	tile_ids.erase(unique(tile_ids.begin(), tile_ids.end()), tile_ids.end());
+	unsigned const num_groups(tile_ids.size());
+	vector<unsigned> group_ixs(tile_ixs.size()), group_end(num_groups+1, 0), sorted_ixs(tile_ixs.size());
+
+	for (unsigned i = 0; i < tile_ixs.size(); ++i) {
+		group_ixs[i] = (lower_bound(tile_ids.begin(), tile_ids.end(), tile_ixs[i].first) - tile_ids.begin());
+		++group_end[group_ixs[i]+1];
+	}
+	for (unsigned g = 0; g < num_groups; ++g) {group_end[g+1] += group_end[g];} // prefix sum; group_end[g] is now the start of group g
+	for (unsigned i = 0; i < tile_ixs.size(); ++i) {sorted_ixs[group_end[group_ixs[i]]++] = tile_ixs[i].second;} // group_end[g] ends as the end of group g
+	reserve(num_groups);
+
+	for (unsigned g = 0, i = 0; g < num_groups; ++g) {
 		unsigned const group_start(new_objs.size());
 		cube_with_ix_t group;
 
-		for (auto i = g->second.begin(); i != g->second.end(); ++i) {
-			assert(*i < objs.size());
-			group.assign_or_union_with_cube(objs[*i].get_outer_bcube());
-			new_objs.push_back(objs[*i]);
+		for (; i < group_end[g]; ++i) {
+			unsigned const ix(sorted_ixs[i]);
+			assert(ix < objs.size());
+			group.assign_or_union_with_cube(objs[ix].get_outer_bcube());
+			new_objs.push_back(objs[ix]);
 		}
 		sort(new_objs.begin()+group_start, new_objs.end());
 		group.ix = new_objs.size();
@@ -658,7 +676,8 @@ template<typename T> void city_obj_groups_t::create_groups(vector<T> &objs, cube
 	} // for g
 	all_objs_bcube.assign_or_union_with_cube(bcube);
 	objs.swap(new_objs);
-	by_tile.clear(); // no longer needed
+	tile_ixs.clear(); // no longer needed
+	tile_ixs.shrink_to_fit();
 }
 
 vect_bird_place_t *select_bird_loc_dest(bool add_pigeons, bool add_birds, vect_bird_place_t &pigeon_locs, vect_bird_place_t &bird_locs, rand_gen_t &rgen) {
@@ -704,23 +723,14 @@ bool check_path_tree_coll(park_path_t const &path, vector<point> const &tree_pos
 float get_power_pole_height() {return 0.9*city_params.road_width;}
 
 // this version is for checking against blockers placed in a previous step
-bool is_placement_blocked(cube_t const &cube, vect_cube_t const &blockers, cube_t const &exclude, unsigned prev_blockers_end, float expand=0.0, bool exp_dim=0) {
+bool is_placement_blocked(cube_t const &cube, placement_blockers_t const &blockers, cube_t const &exclude, unsigned prev_blockers_end, float expand=0.0, bool exp_dim=0) {
 	cube_t query_cube(cube);
 	query_cube.expand_in_dim(exp_dim, expand);
-
-	for (auto b = blockers.begin(); b != blockers.begin()+prev_blockers_end; ++b) {
-		if (*b != exclude && b->intersects_xy_no_adj(query_cube)) return 1;
-	}
-	return 0;
+	return blockers.has_int_xy_no_adj(query_cube, 0, prev_blockers_end, &exclude);
 }
 // this version is for checking against blockers placed in the current step
-bool is_placement_blocked_recent(cube_t const &cube, vect_cube_t const &blockers, unsigned blockers_start) {
-	assert(blockers_start <= blockers.size());
-
-	for (auto b = blockers.begin()+blockers_start; b != blockers.end(); ++b) {
-		if (b->intersects_xy_no_adj(cube)) return 1;
-	}
-	return 0;
+bool is_placement_blocked_recent(cube_t const &cube, placement_blockers_t const &blockers, unsigned blockers_start) {
+	return blockers.has_int_xy_no_adj(cube, blockers_start, blockers.size());
 }
 bool check_close_to_door(point const &pos, float min_dist, unsigned building_ix) {
 	point door_pos;
@@ -793,7 +803,7 @@ point line_line_intersect_xy(point const &p1, point const &q1, point const &p2,
 }
 
 // Note: blockers are used for placement of objects within this plot; colliders are used for pedestrian AI; plot is non-const so that we can set no_draw flag for parks
-void city_obj_placer_t::place_detail_objects(road_plot_t &plot, vect_cube_t &blockers, vect_cube_t &colliders, vector<point> &tree_pos, vect_cube_t const &pond_blockers,
+void city_obj_placer_t::place_detail_objects(road_plot_t &plot, placement_blockers_t &blockers, vect_cube_t &colliders, vector<point> &tree_pos, vect_cube_t const &pond_blockers,
 	vect_cube_t const &plot_cuts, unsigned city_id, unsigned plot_ix, unsigned plot_id_offset, rand_gen_t &rgen, bool have_streetlights)
 {
 	bool const is_residential(plot.is_residential), is_park(plot.is_park);
@@ -1659,7 +1669,7 @@ float extend_fence_to_house(cube_t &fence, cube_t const &house, float fence_hwid
 	return dist;
 }
 bool check_valid_house_obj_place(point const &pos, float height, float radius, float wall_pos, bool dim, bool dir, cube_t const &bcube,
-	cube_with_ix_t const &house, vect_cube_t const &blockers, unsigned prev_blockers_end, unsigned yard_blockers_start)
+	cube_with_ix_t const &house, placement_blockers_t const &blockers, unsigned prev_blockers_end, unsigned yard_blockers_start)
 {
 	point const center(pos + 0.5*height*plus_z);
 	if (is_placement_blocked(bcube, blockers, house, prev_blockers_end))   return 0; // check blockers from prev step; no expand
@@ -1674,7 +1684,7 @@ bool check_valid_house_obj_place(point const &pos, float height, float radius, f
 	return 1;
 }
 
-void city_obj_placer_t::place_residential_plot_objects(road_plot_t const &plot, vect_cube_t &blockers, vect_cube_t &colliders, vector<road_t> const &roads,
+void city_obj_placer_t::place_residential_plot_objects(road_plot_t const &plot, placement_blockers_t &blockers, vect_cube_t &colliders, vector<road_t> const &roads,
 	vect_cube_t const &pool_blockers, unsigned driveways_start, unsigned plot_ix, unsigned city_ix, rand_gen_t &rgen)
 {
 	assert(plot_subdiv_sz > 0.0);
@@ -2088,7 +2098,7 @@ void city_obj_placer_t::place_residential_plot_objects(road_plot_t const &plot,
 
 bool city_obj_placer_t::place_swimming_pool(road_plot_t const &plot, city_zone_t const &yard, cube_with_ix_t const &house, bool dim, bool dir,
 	bool shrink_dim, unsigned prev_blockers_end, unsigned plot_ix, unsigned city_ix, float divider_hwidth, float const translate_dist[2],
-	vect_cube_t const &pool_blockers, vect_cube_t &blockers, vect_cube_t &colliders, rand_gen_t &rgen)
+	vect_cube_t const &pool_blockers, placement_blockers_t &blockers, vect_cube_t &colliders, rand_gen_t &rgen)
 {
 	if (rgen.rand_float() < 0.05) return 0; // add pools 95% of the time (since placing them often fails anyway)
 	cube_t pool_area(yard);
@@ -2269,7 +2279,8 @@ bool city_obj_placer_t::place_swimming_pool(road_plot_t const &plot, city_zone_t
 					place_area.expand_in_dim(!dim, -0.10*hwidth);
 					point pos, door_pos;
 					// use custom blockers that includes the ladder and pillars but not the deck
-					vect_cube_t chair_blockers(blockers.begin(), blockers.begin()+pre_pool_blockers_end);
+					placement_blockers_t chair_blockers; // not reset(), so queries are unindexed
+					chair_blockers.assign(blockers.begin(), blockers.begin()+pre_pool_blockers_end);
 					chair_blockers.push_back(ladder);
 					vector_add_to(pdeck.pillars, chair_blockers);
 					
@@ -2569,7 +2580,8 @@ void city_obj_placer_t::gen_parking_and_place_objects(vector<road_plot_t> &plots
 {
 	// Note: fills in plots.has_parking
 	//highres_timer_t timer("Gen Parking Lots and Place Objects");
-	vect_cube_t blockers, temp_cubes, underground_blockers; // blockers, driveways, extended basement rooms
+	placement_blockers_t blockers;
+	vect_cube_t temp_cubes, underground_blockers; // driveways, extended basement rooms
 	vector<point> tree_pos, hospital_signs;
 	rand_gen_t rgen, detail_rgen;
 	rgen.set_state(city_id, 123);
@@ -2597,7 +2609,7 @@ void city_obj_placer_t::gen_parking_and_place_objects(vector<road_plot_t> &plots
 	}
 	for (auto i = plots.begin(); i != plots.end(); ++i) {
 		tree_pos.clear();
-		blockers.clear();
+		blockers.reset(*i);
 		get_building_bcubes(*i, blockers);
 		size_t const plot_id(i - plots.begin()), buildings_end(blockers.size());
 		assert(plot_id < plot_colliders.size());
@@ -2633,56 +2645,63 @@ void city_obj_placer_t::gen_parking_and_place_objects(vector<road_plot_t> &plots
 	add_ssign_and_slight_plot_colliders(plots, isecs, plot_colliders);
 	connect_power_to_buildings(plots);
 	if (have_cars && is_residential) {add_cars_to_driveways(cars, plots, plot_colliders, city_id, rgen);}
-	place_birds(city_bcube, rgen); // after placing other objects
-	bench_groups   .create_groups(benches,   all_objs_bcube);
-	planter_groups .create_groups(planters,  all_objs_bcube);
-	trashcan_groups.create_groups(trashcans, all_objs_bcube);
-	fhydrant_groups.create_groups(fhydrants, all_objs_bcube);
-	sstation_groups.create_groups(sstations, all_objs_bcube);
-	fountain_groups.create_groups(fountains, all_objs_bcube);
-	wfount_groups  .create_groups(wfounts,   all_objs_bcube);
-	statue_groups  .create_groups(statues,   all_objs_bcube);
-	divider_groups .create_groups(dividers,  all_objs_bcube);
-	pool_groups    .create_groups(pools,     all_objs_bcube);
-	plad_groups    .create_groups(pladders,  all_objs_bcube);
-	chair_groups   .create_groups(chairs,    all_objs_bcube);
-	pdeck_groups   .create_groups(pdecks,    all_objs_bcube);
-	ppole_groups   .create_groups(ppoles,    all_objs_bcube);
-	hcap_groups    .create_groups(hcaps,     all_objs_bcube);
-	manhole_groups .create_groups(manholes,  all_objs_bcube);
-	sewer_groups   .create_groups(sewers,    all_objs_bcube);
-	mbox_groups    .create_groups(mboxes,    all_objs_bcube);
-	tcone_groups   .create_groups(tcones,    all_objs_bcube);
-	sculpt_groups  .create_groups(sculptures,all_objs_bcube);
-	pigeon_groups  .create_groups(pigeons,   all_objs_bcube);
-	bird_groups    .create_groups(birds,     all_objs_bcube);
-	sign_groups    .create_groups(signs,     all_objs_bcube);
-	stopsign_groups.create_groups(stopsigns, all_objs_bcube);
-	flag_groups    .create_groups(flags,     all_objs_bcube);
-	nrack_groups   .create_groups(newsracks, all_objs_bcube);
-	park_wf_groups .create_groups(park_wfs,  all_objs_bcube);
-	pgate_groups   .create_groups(pgates,    all_objs_bcube);
-	cline_groups   .create_groups(clines,    all_objs_bcube);
-	ppath_groups   .create_groups(ppaths,    all_objs_bcube);
-	swing_groups   .create_groups(swings,    all_objs_bcube);
-	tramp_groups   .create_groups(tramps,    all_objs_bcube);
-	umbrella_groups.create_groups(umbrellas, all_objs_bcube);
-	bike_groups    .create_groups(bikes,     all_objs_bcube);
-	dumpster_groups.create_groups(dumpsters, all_objs_bcube);
-	plant_groups   .create_groups(plants,    all_objs_bcube);
-	flower_groups  .create_groups(flowers,   all_objs_bcube);
-	picnic_groups  .create_groups(picnics,   all_objs_bcube);
-	bb_hoop_groups .create_groups(bb_hoops,  all_objs_bcube);
-	pond_groups    .create_groups(ponds,     all_objs_bcube);
-	walkway_groups .create_groups(walkways,  all_objs_bcube);
-	pillar_groups  .create_groups(pillars,   all_objs_bcube);
-	wwe_groups     .create_groups(elevators, all_objs_bcube);
-	uge_groups     .create_groups(ug_elevs,  all_objs_bcube);
-	p_solar_groups .create_groups(p_solars,  all_objs_bcube);
-	gass_groups    .create_groups(gstations, all_objs_bcube);
-	bldg_groups    .create_groups(bldgs,     all_objs_bcube);
-	bball_groups   .create_groups(bballs,    all_objs_bcube);
-	pfloat_groups  .create_groups(pfloats,   all_objs_bcube);
+	place_birds(city_bcube, rgen); // after placing other objects, but before create_groups() reorders them, since rgen is consumed in object order
+	// each object type's groups are independent, so create them in parallel, then union the bcubes in the original order
+	vector<function<void(cube_t &)>> group_funcs;
+	auto add_groups = [&group_funcs](auto &groups, auto &objs) {group_funcs.push_back([&groups, &objs](cube_t &bc) {groups.create_groups(objs, bc);});};
+	add_groups(bench_groups,    benches);
+	add_groups(planter_groups,  planters);
+	add_groups(trashcan_groups, trashcans);
+	add_groups(fhydrant_groups, fhydrants);
+	add_groups(sstation_groups, sstations);
+	add_groups(fountain_groups, fountains);
+	add_groups(wfount_groups,   wfounts);
+	add_groups(statue_groups,   statues);
+	add_groups(divider_groups,  dividers);
+	add_groups(pool_groups,     pools);
+	add_groups(plad_groups,     pladders);
+	add_groups(chair_groups,    chairs);
+	add_groups(pdeck_groups,    pdecks);
+	add_groups(ppole_groups,    ppoles);
+	add_groups(hcap_groups,     hcaps);
+	add_groups(manhole_groups,  manholes);
+	add_groups(sewer_groups,    sewers);
+	add_groups(mbox_groups,     mboxes);
+	add_groups(tcone_groups,    tcones);
+	add_groups(sculpt_groups,   sculptures);
+	add_groups(pigeon_groups,   pigeons);
+	add_groups(bird_groups,     birds);
+	add_groups(sign_groups,     signs);
+	add_groups(stopsign_groups, stopsigns);
+	add_groups(flag_groups,     flags);
+	add_groups(nrack_groups,    newsracks);
+	add_groups(park_wf_groups,  park_wfs);
+	add_groups(pgate_groups,    pgates);
+	add_groups(cline_groups,    clines);
+	add_groups(ppath_groups,    ppaths);
+	add_groups(swing_groups,    swings);
+	add_groups(tramp_groups,    tramps);
+	add_groups(umbrella_groups, umbrellas);
+	add_groups(bike_groups,     bikes);
+	add_groups(dumpster_groups, dumpsters);
+	add_groups(plant_groups,    plants);
+	add_groups(flower_groups,   flowers);
+	add_groups(picnic_groups,   picnics);
+	add_groups(bb_hoop_groups,  bb_hoops);
+	add_groups(pond_groups,     ponds);
+	add_groups(walkway_groups,  walkways);
+	add_groups(pillar_groups,   pillars);
+	add_groups(wwe_groups,      elevators);
+	add_groups(uge_groups,      ug_elevs);
+	add_groups(p_solar_groups,  p_solars);
+	add_groups(gass_groups,     gstations);
+	add_groups(bldg_groups,     bldgs);
+	add_groups(bball_groups,    bballs);
+	add_groups(pfloat_groups,   pfloats);
+	vector<cube_t> type_bcubes(group_funcs.size()); // starts as all zeros
+#pragma omp parallel for schedule(dynamic,1)
+	for (int i = 0; i < (int)group_funcs.size(); ++i) {group_funcs[i](type_bcubes[i]);}
+	for (cube_t const &bc : type_bcubes) {all_objs_bcube.assign_or_union_with_cube(bc);}
 	if (skyway.valid) {all_objs_bcube.assign_or_union_with_cube(skyway.bcube);}
 	if (add_parking_lots && frame_counter <= 1) {cout << "parking lots: " << parking_lots.size() << ", spaces: " << num_spaces << ", filled: " << filled_spaces << endl;}
 }
@@ -2705,7 +2724,7 @@ void city_obj_placer_t::remap_parking_lot_ixs() {
 }
 
 // also adds signs on the ground near building doors
-void city_obj_placer_t::add_objs_on_buildings(road_plot_t const &plot, vect_cube_t &blockers, vect_cube_t &colliders, vector<point> &hospital_signs) {
+void city_obj_placer_t::add_objs_on_buildings(road_plot_t const &plot, placement_blockers_t &blockers, vect_cube_t &colliders, vector<point> &hospital_signs) {
 	// add signs and flags attached to buildings; note that some signs and flags may have already been added at this point
 	vector<sign_t     > signs_to_add;
 	vector<city_flag_t> flags_to_add;
@@ -3443,6 +3462,103 @@ void cubes_grid_t::finalize() {
 		for (unsigned x = 0; x < NDIV; ++x) {row_bcubes[y].assign_or_union_with_cube(cubes[y][x].bcube);}
 	}
 }
+void placement_blockers_t::reset(cube_t const &bcube) {
+	clear();
+	grid_bcube   = bcube;
+	num_indexed  = 0;
+	for (unsigned d = 0; d < 2; ++d) {cell_sz[d] = max(bcube.get_sz_dim(d), TOLERANCE)/NDIV;}
+
+	for (unsigned y = 0; y < NDIV; ++y) {
+		for (unsigned x = 0; x < NDIV; ++x) {cells[y][x].clear();}
+	}
+}
+void placement_blockers_t::get_cell_range(cube_t const &c, unsigned lo[2], unsigned hi[2]) const {
+	for (unsigned d = 0; d < 2; ++d) { // Note: cubes outside the grid are clamped to the edge cells; cubes may be denormalized
+		float const v[2] = {min(c.d[d][0], c.d[d][1]), max(c.d[d][0], c.d[d][1])};
+
+		for (unsigned e = 0; e < 2; ++e) {
+			float const cix((v[e] - grid_bcube.d[d][0])/cell_sz[d]);
+			(e ? hi : lo)[d] = ((cix <= 0.0) ? 0 : min(NDIV-1, unsigned(cix)));
+		}
+	}
+}
+unsigned placement_blockers_t::get_next_stamp() const {
+	if (++cur_stamp == 0) { // wraparound
+		for (unsigned &s : stamps) {s = 0;}
+		cur_stamp = 1;
+	}
+	return cur_stamp;
+}
+void placement_blockers_t::update_index() const {
+	if (num_indexed > size()) { // cubes were removed; rebuild the index
+		for (unsigned y = 0; y < NDIV; ++y) {
+			for (unsigned x = 0; x < NDIV; ++x) {cells[y][x].clear();}
+		}
+		num_indexed = 0;
+	}
+	if (num_indexed == size() || cell_sz[0] == 0.0) return; // up to date, or reset() wasn't called
+	unsigned lo[2], hi[2];
+
+	for (; num_indexed < size(); ++num_indexed) {
+		get_cell_range(operator[](num_indexed), lo, hi);
+
+		for (unsigned y = lo[1]; y <= hi[1]; ++y) {
+			for (unsigned x = lo[0]; x <= hi[0]; ++x) {cells[y][x].push_back(num_indexed);}
+		}
+	}
+	stamps.resize(size(), 0);
+}
+bool placement_blockers_t::has_int_xy(cube_t const &c, float pad_dist) const {
+	cube_t tc(c);
+	tc.expand_by_xy(pad_dist);
+	update_index();
+
+	if (size() < MIN_INDEX_SZ || num_indexed < size()) { // small or unindexed
+		for (cube_t const &b : *this) {if (b.intersects_xy(tc)) return 1;}
+		return 0;
+	}
+	unsigned const stamp(get_next_stamp());
+	unsigned lo[2], hi[2];
+	get_cell_range(tc, lo, hi);
+
+	for (unsigned y = lo[1]; y <= hi[1]; ++y) {
+		for (unsigned x = lo[0]; x <= hi[0]; ++x) {
+			for (unsigned ix : cells[y][x]) {
+				if (stamps[ix] == stamp) continue; // already checked
+				stamps[ix] = stamp;
+				if (operator[](ix).intersects_xy(tc)) return 1;
+			}
+		}
+	} // for y
+	return 0;
+}
+bool placement_blockers_t::has_int_xy_no_adj(cube_t const &c, unsigned start, unsigned end, cube_t const *exclude) const {
+	assert(start <= end && end <= size());
+	update_index();
+
+	if (end - start < MIN_INDEX_SZ || num_indexed < size()) { // small range or unindexed
+		for (auto b = begin()+start; b != begin()+end; ++b) {
+			if ((exclude == nullptr || *b != *exclude) && b->intersects_xy_no_adj(c)) return 1;
+		}
+		return 0;
+	}
+	unsigned const stamp(get_next_stamp());
+	unsigned lo[2], hi[2];
+	get_cell_range(c, lo, hi);
+
+	for (unsigned y = lo[1]; y <= hi[1]; ++y) {
+		for (unsigned x = lo[0]; x <= hi[0]; ++x) {
+			for (unsigned ix : cells[y][x]) {
+				if (ix < start || ix >= end || stamps[ix] == stamp) continue; // out of range or already checked
+				stamps[ix] = stamp;
+				cube_t const &b(operator[](ix));
+				if ((exclude == nullptr || b != *exclude) && b.intersects_xy_no_adj(c)) return 1;
+			}
+		}
+	} // for y
+	return 0;
+}
+
 bool cubes_grid_t::has_overlap_xy(cube_t const &c, cube_t &blocker) const {
 	for (unsigned y = 0; y < NDIV; ++y) {
 		if (!row_bcubes[y].intersects_xy(c)) continue;
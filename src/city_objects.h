@@ -830,7 +830,7 @@ public:
 };
 
 class city_obj_groups_t : public vector<cube_with_ix_t> {
-	map<uint64_t, vector<unsigned>> by_tile;
+	vector<pair<uint64_t, unsigned>> tile_ixs; // {tile_id, obj_ix} in insertion order
 	cube_t bcube;
 public:
 	cube_t const &get_bcube() const {return bcube;}
@@ -860,6 +860,26 @@ public:
 	void finalize();
 	bool has_overlap_xy(cube_t const &c, cube_t &blocker) const;
 };
+// blockers for object placement within a plot, with a uniform XY grid acceleration structure;
+// cubes may be added or modified through the vect_cube_t interface and are indexed lazily on the next query;
+// Note: indexed cubes may shrink but must not grow unless update_index() is called before they're shrunk
+class placement_blockers_t : public vect_cube_t {
+	static constexpr unsigned NDIV=16, MIN_INDEX_SZ=16; // grid cells in each dim; linear iteration is used for fewer than MIN_INDEX_SZ cubes
+	cube_t grid_bcube;
+	float cell_sz[2]={};
+	mutable unsigned num_indexed=0, cur_stamp=0;
+	mutable vector<unsigned> cells[NDIV][NDIV]; // {y, x}: indices of cubes overlapping each cell
+	mutable vector<unsigned> stamps; // one per indexed cube, to avoid testing cubes in multiple cells more than once
+
+	void get_cell_range(cube_t const &c, unsigned lo[2], unsigned hi[2]) const;
+	unsigned get_next_stamp() const;
+public:
+	void reset(cube_t const &bcube);
+	void update_index() const;
+	bool has_int_xy(cube_t const &c, float pad_dist=0.0) const;
+	bool has_int_xy_no_adj(cube_t const &c, unsigned start, unsigned end, cube_t const *exclude=nullptr) const;
+};
+inline bool has_bcube_int_xy(cube_t const &bcube, placement_blockers_t const &blockers, float pad_dist=0.0) {return blockers.has_int_xy(bcube, pad_dist);}
 
 class city_obj_placer_t : private city_draw_qbds_t {
 public: // road network needs access to parking lots and driveways for drawing
@@ -941,22 +961,22 @@ private:
 	bool gen_parking_lots_for_plot(cube_t const &full_plot, vector<car_t> &cars, unsigned city_id, unsigned plot_ix,
 		vect_cube_t &bcubes, vect_cube_t &colliders, vect_cube_t const &plot_cuts, rand_gen_t &rgen, bool add_cars);
 	void add_cars_to_driveways(vector<car_t> &cars, vector<road_plot_t> const &plots, vector<vect_cube_t> &plot_colliders, unsigned city_id, rand_gen_t &rgen);
-	void place_trees_in_plot(road_plot_t const &plot, vect_cube_t &blockers, vect_cube_t &colliders,
+	void place_trees_in_plot(road_plot_t const &plot, placement_blockers_t &blockers, vect_cube_t &colliders,
 		vector<point> &tree_pos, vect_cube_t const &plot_cuts, rand_gen_t &rgen, unsigned buildings_end);
-	void place_detail_objects(road_plot_t &plot, vect_cube_t &blockers, vect_cube_t &colliders, vector<point> &tree_pos, vect_cube_t const &pond_blockers,
+	void place_detail_objects(road_plot_t &plot, placement_blockers_t &blockers, vect_cube_t &colliders, vector<point> &tree_pos, vect_cube_t const &pond_blockers,
 		vect_cube_t const &plot_cuts, unsigned city_id, unsigned plot_ix, unsigned plot_id_offset, rand_gen_t &rgen, bool have_streetlights);
-	void place_residential_plot_objects(road_plot_t const &plot, vect_cube_t &blockers, vect_cube_t &colliders, vector<road_t> const &roads,
+	void place_residential_plot_objects(road_plot_t const &plot, placement_blockers_t &blockers, vect_cube_t &colliders, vector<road_t> const &roads,
 		vect_cube_t const &pool_blockers, unsigned driveways_start, unsigned plot_ix, unsigned city_ix, rand_gen_t &rgen);
 	bool place_swimming_pool(road_plot_t const &plot, city_zone_t const &yard, cube_with_ix_t const &house, bool dim, bool dir, bool shrink_dim,
 		unsigned prev_blockers_end, unsigned plot_ix, unsigned city_ix, float divider_hwidth, float const translate_dist[2],
-		vect_cube_t const &pool_blockers, vect_cube_t &blockers, vect_cube_t &colliders, rand_gen_t &rgen);
+		vect_cube_t const &pool_blockers, placement_blockers_t &blockers, vect_cube_t &colliders, rand_gen_t &rgen);
 	bool check_bird_walkway_clearance(cube_t const &bc) const;
 	void place_birds(cube_t const &city_bcube, rand_gen_t &rgen);
 	void add_building_driveways(road_plot_t const &plot, vect_cube_t &temp_cubes, rand_gen_t &rgen, unsigned plot_ix);
 	void place_stopsigns_in_isec(road_isec_t &isec);
 	void place_objects_in_isec(road_isec_t &isec, bool is_residential, vector<point> const &hospital_signs, rand_gen_t &rgen);
 	void add_ssign_and_slight_plot_colliders(vector<road_plot_t> const &plots, vector<road_isec_t> const isecs[3], vector<vect_cube_t> &plot_colliders) const;
-	void add_objs_on_buildings(road_plot_t const &plot, vect_cube_t &blockers, vect_cube_t &colliders, vector<point> &hospital_signs);
+	void add_objs_on_buildings(road_plot_t const &plot, placement_blockers_t &blockers, vect_cube_t &colliders, vector<point> &hospital_signs);
 	template<typename T> void draw_objects(vector<T> const &objs, city_obj_groups_t const &groups, draw_state_t &dstate,
 		float dist_scale, bool shadow_only, bool has_immediate_draw=0, bool draw_qbd_as_quads=0, float specular=0.75, float shininess=50.0);
 	bool connect_power_to_point(point const &at_pos, bool near_power_pole, bool power_only);
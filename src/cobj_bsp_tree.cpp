@@ -432,6 +432,46 @@ bool cobj_bvh_tree::check_point_contained(point const &p, int &cindex) const {
 	return 0;
 }
 
+// tests a group of nearby points pts[ixs[0..npts-1]] together so that they share the tree traversal; sets contained[ix] for each contained point
+void cobj_bvh_tree::check_points_contained(point const *const pts, unsigned const *const ixs, unsigned npts, unsigned char *const contained) const {
+
+	assert(npts <= 64); // must fit in active_mask
+	unsigned const num_nodes((unsigned)nodes.size());
+	uint64_t active_mask(0);
+	cube_t bcube;
+
+	for (unsigned k = 0; k < npts; ++k) {
+		if (contained[ixs[k]]) continue; // already contained in another tree
+		if (active_mask == 0) {bcube.set_from_point(pts[ixs[k]]);} else {bcube.union_with_pt(pts[ixs[k]]);}
+		active_mask |= (1ULL << k);
+	}
+	for (unsigned nix = 0; nix < num_nodes && active_mask;) {
+		tree_node const &n(nodes[nix]);
+
+		if (!n.intersects(bcube)) {
+			assert(n.next_node_id > nix);
+			nix = n.next_node_id; // failed the bbox test for all points
+			continue;
+		}
+		if (n.start < n.end) { // check leaves against each remaining point
+			for (unsigned k = 0; k < npts; ++k) {
+				if (!(active_mask & (1ULL << k))) continue;
+				point const &p(pts[ixs[k]]);
+				if (!n.contains_pt(p)) continue;
+
+				for (unsigned i = n.start; i < n.end; ++i) {
+					coll_obj const &c(get_cobj(i));
+					if (!c.contains_point(p) || !obj_ok(c)) continue;
+					contained[ixs[k]] = 1;
+					active_mask &= ~(1ULL << k);
+					break;
+				}
+			} // for k
+		}
+		++nix;
+	}
+}
+
 void cobj_bvh_tree::get_intersecting_cobjs(cube_t const &cube, vector<unsigned> &cobjs,
 	int ignore_cobj, float toler, bool check_ccounter, int id_for_cobj_int) const
 {
@@ -774,6 +814,45 @@ bool check_point_contained_tree(point const &p, int &cindex, bool dynamic) { //
 	return 0;
 }
 
+inline unsigned morton_spread_bits(unsigned v) { // spreads the low 10 bits of v so that there are two zero bits between each bit
+	v &= 0x3FF;
+	v = (v | (v << 16)) & 0x030000FF;
+	v = (v | (v <<  8)) & 0x0300F00F;
+	v = (v | (v <<  4)) & 0x030C30C3;
+	v = (v | (v <<  2)) & 0x09249249;
+	return v;
+}
+
+// batched version of check_point_contained_tree(): points are sorted by Morton code and tested in groups of nearby points that share the tree traversal
+void check_points_contained_tree(vector<point> const &pts, vector<unsigned char> &contained, bool dynamic) { // Note: doesn't test voxels
+	unsigned const GROUP_SIZE = 32;
+	unsigned const npts(pts.size());
+	contained.clear();
+	contained.resize(npts, 0);
+	if (pts.empty()) return;
+	cube_t const bcube(pts.data(), npts);
+	vector3d const size(bcube.get_size());
+	vector<pair<unsigned, unsigned> > order(npts); // {Morton code, index}
+
+	for (unsigned i = 0; i < npts; ++i) {
+		unsigned code(0);
+		UNROLL_3X(code |= (morton_spread_bits((size[i_] > 0.0) ? unsigned(1023.0f*(pts[i][i_] - bcube.d[i_][0])/size[i_]) : 0U) << i_);)
+		order[i] = make_pair(code, i);
+	}
+	sort(order.begin(), order.end());
+	vector<unsigned> ixs(npts);
+	for (unsigned i = 0; i < npts; ++i) {ixs[i] = order[i].second;}
+	cobj_bvh_tree const &tree(get_tree(dynamic));
+	int const num_groups((npts + GROUP_SIZE - 1)/GROUP_SIZE);
+
+#pragma omp parallel for schedule(dynamic,4) if (num_groups > 16)
+	for (int g = 0; g < num_groups; ++g) {
+		unsigned const start(g*GROUP_SIZE), num(min(GROUP_SIZE, npts - start));
+		tree.check_points_contained(pts.data(), ixs.data()+start, num, contained.data());
+		if (!dynamic) {cobj_tree_static_moving.check_points_contained(pts.data(), ixs.data()+start, num, contained.data());}
+	}
+}
+
 bool have_occluders() {
 	return !cobj_tree_occlude.is_empty();
 }
@@ -345,6 +345,7 @@ void final_draw(float framerate) {
 
 void swap_buffers_and_redraw() {
 	glutSwapBuffers();
+	maybe_capture_video_frame(window_width, window_height); // reads the front buffer
 	if (animate) {post_window_redisplay();} // before glutSwapBuffers()?
 }
 
@@ -72,6 +72,7 @@ public:
 	void clear() {points.clear();}
 	void reserve_pts(unsigned sz) {points.reserve(sz);}
 	void add_pt(vert_type_t const &v) {points.push_back(v);}
+	void add_pts(vector<vert_type_t> const &v) {vector_add_to(v, points);}
 	void sort_back_to_front();
 	void draw(int tid, float const_point_size=0.0, bool enable_lighting=0, bool use_geom_shader=0, float min_alpha=0.0) const;
 	void draw_and_clear(int tid, float const_point_size=0.0, bool enable_lighting=0, bool use_geom_shader=0, float min_alpha=0.0) {
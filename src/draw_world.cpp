@@ -1495,15 +1495,14 @@ void draw_part_clouds(vector<particle_cloud> const &pc, int tid) {
 
 void physics_particle_manager::draw(float radius, int tid, bool emissive) const {
 
-	if (parts.empty()) return;
+	if (pos.empty()) return;
 	point const camera(get_camera_pos());
 	enable_blend();
 	point_sprite_drawer_norm_sized psd;
-	psd.reserve_pts(parts.size());
+	psd.reserve_pts(pos.size());
 
-	for (unsigned i = 0; i < parts.size(); ++i) {
-		//psd.add_pt(vert_norm_color(parts[i].p, (camera - parts[i].p).get_norm(), parts[i].c.c), radius); // normal faces camera
-		psd.add_pt(sized_vert_t<vert_norm_color>(vert_norm_color(parts[i].p, (camera - parts[i].p).get_norm(), parts[i].c.c), radius)); // normal faces camera
+	for (unsigned i = 0; i < pos.size(); ++i) {
+		psd.add_pt(sized_vert_t<vert_norm_color>(vert_norm_color(pos[i], (camera - pos[i]).get_norm(), colors[i].c), radius)); // normal faces camera
 	}
 	if (tid >= 0) {psd.sort_back_to_front();} // if we have an alpha texture, sort back to front
 	psd.draw(tid, 0.0, !emissive); // draw with lighting
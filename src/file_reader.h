@@ -17,11 +17,13 @@ protected:
 	static unsigned const MAX_CHARS = 1024;
 	bool verbose=0;
 	char buffer[MAX_CHARS] = {0};
-	char *file_buf; // size FILE_BUF_SZ, allocated on the heap to avoid a large stack size
+	char *file_buf; // size FILE_BUF_SZ, allocated on the heap to avoid a large stack size; or the entire file after load_entire_file()
 	unsigned file_buf_pos=0, file_buf_end=0;
+	bool whole_file_loaded=0;
 
 	bool open_file(bool binary=0);
 	void close_file();
+	bool load_entire_file();
 	char get_next_char() {assert(fp); return get_char(fp);}
 	static bool fast_isspace(char c) {return (c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r');}
 	static bool fast_isdigit(char c) {return (c >= '0' && c <= '9');}
@@ -35,6 +37,7 @@ protected:
 	char get_char(FILE *fp_) {
 		//if (FILE_BUF_SZ == 0) {return _getc_nolock(fp_);}
 		if (file_buf_pos == file_buf_end) { // fill file buffer
+			if (whole_file_loaded) return EOF; // end of file; keep the file position
 			file_buf_pos = 0;
 			file_buf_end = fread(file_buf, 1, FILE_BUF_SZ, fp);
 			if (file_buf_end == 0) return EOF; // end of file
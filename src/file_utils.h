@@ -4,6 +4,7 @@
 #pragma once
 
 #include <fstream>
+#include <unordered_map>
 #include <inttypes.h> // for SCNu64
 #include "3DWorld.h"
 
@@ -11,16 +12,18 @@ inline bool is_EOF(int v) {return (v == EOF || v == '\0');}
 inline bool is_end_of_string(int v) {return (v == '#' || isspace(v) || is_EOF(v));}
 bool read_block_comment(FILE *fp);
 
-inline bool read_int   (FILE *fp, int      &val) {return (fscanf(fp, "%i", &val) == 1);}
-inline bool read_uint  (FILE *fp, unsigned &val) {return (fscanf(fp, "%u", &val) == 1);}
-inline bool read_uint64(FILE *fp, uint64_t &val) {return (fscanf(fp, "%" SCNu64, &val) == 1);}
-inline bool read_nonzero_uint(FILE *fp, unsigned &val) {return (fscanf(fp, "%u", &val) == 1 && val > 0);}
-inline bool read_float(FILE *fp, float    &val) {return (fscanf(fp, "%f", &val) == 1);}
+// Note: these are used in place of fscanf(), which is slow due to format string parsing and per-call stream locking;
+// they accept the same inputs as the equivalent fscanf() format, except that floats are converted with fast_atof()
+bool read_int   (FILE *fp, int      &val); // "%i"
+bool read_uint  (FILE *fp, unsigned &val); // "%u"
+bool read_uint64(FILE *fp, uint64_t &val); // "%" SCNu64
+bool read_float (FILE *fp, float    &val); // "%f"
+bool read_double(FILE *fp, double   &val); // "%lf"
+bool read_str   (FILE *fp, char     *val); // "%255s"
+inline bool read_nonzero_uint(FILE *fp, unsigned &val) {return (read_uint(fp, val) && val > 0);}
 inline bool read_pos_float     (FILE *fp, float &val) {return (read_float(fp, val) && val >  0.0);}
 inline bool read_non_neg_float (FILE *fp, float &val) {return (read_float(fp, val) && val >= 0.0);}
 inline bool read_zero_one_float(FILE *fp, float &val) {return (read_float(fp, val) && val >= 0.0 && val <= 1.0);}
-inline bool read_double(FILE *fp, double   &val) {return (fscanf(fp, "%lf",  &val) == 1);}
-inline bool read_str   (FILE *fp, char     *val) {return (fscanf(fp, "%255s", val) == 1);}
 
 inline bool check_file_exists(std::string const &fn) {return std::ifstream(fn).good();}
 
@@ -37,17 +40,19 @@ inline void write_binary_uint(FILE *fp, unsigned v) {
 }
 
 inline bool read_vector(FILE *fp, vector3d &v) { // or point
-	return (fscanf(fp, "%f%f%f", &v.x, &v.y, &v.z) == 3);
+	return (read_float(fp, v.x) && read_float(fp, v.y) && read_float(fp, v.z));
 }
 
 inline bool read_color(FILE *fp, colorRGBA &c) {
 	c.A = 1.0; // default
-	return (fscanf(fp, "%f%f%f%f", &c.R, &c.G, &c.B, &c.A) >= 3); // alpha is optional
+	if (!read_float(fp, c.R) || !read_float(fp, c.G) || !read_float(fp, c.B)) return 0;
+	read_float(fp, c.A); // alpha is optional
+	return 1;
 }
 
 inline bool read_bool (FILE *fp, bool     &val) {
 	int tmp;
-	if (fscanf(fp, "%i", &tmp) != 1) return 0;
+	if (!read_int(fp, tmp)) return 0;
 	val = (tmp != 0);
 	return 1;
 }
@@ -60,7 +65,8 @@ inline bool read_string(FILE *fp, std::string &str) {
 }
 
 inline int read_cube(FILE *fp, cube_t &c, bool z_is_optional=0) { // x1 x2 y1 y2 [z1 z2]
-	int const num_read(fscanf(fp, "%f%f%f%f%f%f", &c.d[0][0], &c.d[0][1], &c.d[1][0], &c.d[1][1], &c.d[2][0], &c.d[2][1]));
+	int num_read(0);
+	while (num_read < 6 && read_float(fp, c.d[num_read>>1][num_read&1])) {++num_read;}
 	if (z_is_optional && num_read == 4) {c.d[2][0] = c.d[2][1] = 0.0; return 2;} // zvals only
 	return (num_read == 6);
 }
@@ -86,7 +92,7 @@ struct geom_xform_t;
 unsigned read_cube(FILE *fp, geom_xform_t const &xf, cube_t &c);
 
 template<typename T> class kw_to_val_map_t {
-	map<std::string, T*> m;
+	std::unordered_map<std::string, T*> m; // hashed, since these are queried once per config file token
 	int &error;
 	std::string opt_prefix;
 public:
@@ -108,7 +114,7 @@ class kw_to_val_map_float_check_t {
 		map_val_t(float *v_, unsigned check_mode_) : v(v_), check_mode(check_mode_) {}
 		bool check_val() const;
 	};
-	map<std::string, map_val_t> m;
+	std::unordered_map<std::string, map_val_t> m;
 	int &error;
 	std::string opt_prefix;
 public:
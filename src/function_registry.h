@@ -468,6 +468,7 @@ void get_coll_line_cobjs_tree(point const &pos1, point const &pos2, int ignore_c
 	vector<int> *cobjs, cobj_query_callback *cqc, bool dynamic, bool occlude, bool do_expand);
 void get_coll_sphere_cobjs_tree(point const &center, float radius, int cobj, vert_coll_detector &vcd, bool dynamic);
 bool check_point_contained_tree(point const &p, int &cindex, bool dynamic);
+void check_points_contained_tree(vector<point> const &pts, vector<unsigned char> &contained, bool dynamic);
 bool have_occluders();
 void get_intersecting_cobjs_tree(cube_t const &cube, vector<unsigned> &cobjs, int ignore_cobj, float toler,
 	bool dynamic, bool check_ccounter, int id_for_cobj_int=-1);
@@ -929,6 +930,8 @@ void modify_voxels();
 void read_depth_buffer(unsigned window_width, unsigned window_height, vector<float> &depth, bool normalize=0);
 void read_pixels(unsigned window_width, unsigned window_height, vector<unsigned char> &buf);
 int screenshot(unsigned window_width, unsigned window_height, char const *const file_path, bool write_bmp);
+void toggle_video_recording();
+void maybe_capture_video_frame(unsigned window_width, unsigned window_height);
 
 // function prototypes - spray paint
 void toggle_spraypaint_mode();
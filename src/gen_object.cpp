@@ -335,19 +335,19 @@ void gen_leaf_at(point const *const points, vector3d const &normal, int type, co
 }
 
 
-void physics_particle_manager::gen_particles(point const &pos, vector3d const &vadd, float vmag, float gen_radius, colorRGBA const &color, unsigned num) {
+void physics_particle_manager::gen_particles(point const &center, vector3d const &vadd, float vmag, float gen_radius, colorRGBA const &color, unsigned num) {
 
-	if (!is_pos_valid(pos)) return; // origin invalid
+	if (!is_pos_valid(center)) return; // origin invalid
 	unsigned const MAX_PARTS = 100000; // limit of 100K particles
-	if (parts.size() >= MAX_PARTS) return; // too may particles
-	num = min(num, unsigned(parts.size() - MAX_PARTS));
+	if (pos.size() >= MAX_PARTS) return; // too may particles
+	num = min(num, unsigned(pos.size() - MAX_PARTS));
 
 	for (unsigned i = 0; i < num; ++i) {
 		point ppos;
-		do {ppos = pos + signed_rand_vector_spherical(gen_radius);} while (!is_pos_valid(ppos)); // find a valid particle starting pos
+		do {ppos = center + signed_rand_vector_spherical(gen_radius);} while (!is_pos_valid(ppos)); // find a valid particle starting pos
 		vector3d pvel(vadd + signed_rand_vector_spherical(vmag));
 		if (pvel.z < 0.0) {pvel.z *= -1.0;} // make sure it's going up
-		parts.push_back(part_t(ppos, pvel, color));
+		add_particle(ppos, pvel, color);
 	}
 }
 
@@ -77,23 +77,36 @@ vector3d grass_manager_t::interpolate_mesh_normal(point const &pos) const { // N
 		 + vertex_normals[y0+1][x0+1]*(xpi*ypi);
 }
 
-void grass_manager_t::add_grass_blade_int(point const &pos, float cscale, bool on_mesh, vector<grass_t> &grass_, rand_gen_pregen_t &rgen_) const {
+grass_manager_t::blade_color_t::blade_color_t(float cscale) {
 
-	vector3d const base_dir(on_mesh ? 0.5*(plus_z + interpolate_mesh_normal(pos)) : plus_z); // average mesh normal and +z for grass on mesh
-	vector3d const dir((base_dir + rgen_.signed_rand_vector(0.3)).get_norm());
-	vector3d const norm(cross_product(dir, rgen_.signed_rand_vector()).get_norm());
-	float const ilch(1.0 - leaf_color_coherence), dead_scale(CLIP_TO_01(tree_deadness));
+	float const ilch(1.0 - leaf_color_coherence);
 	float const grass_color_var((world_mode == WMODE_INF_TERRAIN) ? 0.5 : 1.0); // less color variation in tiled terrain mode (to match ground texture)
 	float const base_color[3] = {0.25, 0.6, 0.08};
 	float const mod_color [3] = {0.3,  0.3, 0.12};
 	float const lbc_mult  [3] = {0.2,  0.4, 0.0 };
 	float const dead_color[3] = {0.75, 0.6, 0.0 };
-	unsigned char color[3] = {};
+	dead_scale = CLIP_TO_01(tree_deadness);
 
 	for (unsigned i = 0; i < 3; ++i) {
-		float const ccomp(CLIP_TO_01(cscale*(base_color[i] + grass_color_var*lbc_mult[i]*leaf_base_color[i] + ilch*mod_color[i]*rgen_.rand_float())));
-		color[i] = (unsigned char)(255.0f*(dead_scale*dead_color[i] + (1.0f - dead_scale)*ccomp));
+		add [i] = cscale*(base_color[i] + grass_color_var*lbc_mult[i]*leaf_base_color[i]);
+		mul [i] = cscale*ilch*mod_color[i];
+		dead[i] = dead_scale*dead_color[i];
 	}
+}
+
+void grass_manager_t::blade_color_t::gen(float const rvals[3], unsigned char color[3]) const {
+	UNROLL_3X(color[i_] = (unsigned char)(255.0f*(dead[i_] + (1.0f - dead_scale)*CLIP_TO_01(add[i_] + mul[i_]*rvals[i_])));)
+}
+
+void grass_manager_t::add_grass_blade_int(point const &pos, float cscale, bool on_mesh, vector<grass_t> &grass_, rand_gen_pregen_t &rgen_) const {
+
+	vector3d const base_dir(on_mesh ? 0.5*(plus_z + interpolate_mesh_normal(pos)) : plus_z); // average mesh normal and +z for grass on mesh
+	vector3d const dir((base_dir + rgen_.signed_rand_vector(0.3)).get_norm());
+	vector3d const norm(cross_product(dir, rgen_.signed_rand_vector()).get_norm());
+	float rvals[3];
+	unsigned char color[3] = {};
+	UNROLL_3X(rvals[i_] = rgen_.rand_float();)
+	blade_color_t(cscale).gen(rvals, color);
 	float const length(grass_length*rgen_.rand_uniform(0.7, 1.3));
 	float const width( grass_width *rgen_.rand_uniform(0.7, 1.3));
 	grass_.emplace_back(pos, dir*length, norm, color, width, on_mesh);
@@ -117,6 +130,19 @@ void grass_manager_t::add_to_vbo_data(grass_t const &g, vector<grass_data_t> &da
 	data[ix++].assign(p2,        nc.n, g.c);
 }
 
+void grass_manager_t::create_vbo_data(vector<grass_data_t> &data) const { // no GL calls
+
+	data.resize(3*size()); // 3 vertices per grass blade
+
+#pragma omp parallel for schedule(static) if (size() > 10000)
+	for (int i = 0; i < (int)size(); ++i) {
+		unsigned ix(3*i);
+		vector3d const &norm(plus_z); // use grass normal? 2-sided lighting? generate normals in vertex shader?
+		//vector3d const &norm(grass[i].n);
+		add_to_vbo_data(grass[i], data, ix, norm);
+	}
+}
+
 void grass_manager_t::scale_grass(float lscale, float wscale) {
 	for (auto i = grass.begin(); i != grass.end(); ++i) {
 		i->dir *= lscale;
@@ -137,31 +163,52 @@ void grass_manager_t::end_draw() const {
 }
 
 
-void grass_tile_manager_t::gen_block(unsigned bix) {
+void grass_tile_manager_t::gen_block(vector<grass_t> &grass_, rand_gen_pregen_t &rgen_) const {
 
+	unsigned const num_blades(GRASS_BLOCK_SZ*GRASS_BLOCK_SZ*grass_density);
 	float const rscale_x(DX_VAL/2147483562.0), rscale_y(DY_VAL/2147483562.0);
+	vector<point> pos(num_blades);
+	vector<vector3d> rdir(num_blades), rnorm(num_blades);
+	vector<float> rvals(5*num_blades); // {color R, G, B, length, width}
+	unsigned ix(0);
 
+	// pass 1: all random draws, which are serial
 	for (unsigned y = 0; y < GRASS_BLOCK_SZ; ++y) {
 		for (unsigned x = 0; x < GRASS_BLOCK_SZ; ++x) {
 			float const xval(x*DX_VAL), yval(y*DY_VAL);
 
-			for (unsigned n = 0; n < grass_density; ++n) {
-				add_grass_blade(point((xval + rscale_x*rgen.rand()), (yval + rscale_y*rgen.rand()), 0.0), TT_GRASS_COLOR_SCALE, 0); // no mesh normal
+			for (unsigned n = 0; n < grass_density; ++n, ++ix) {
+				pos  [ix] = point((xval + rscale_x*rgen_.rand()), (yval + rscale_y*rgen_.rand()), 0.0);
+				rdir [ix] = rgen_.signed_rand_vector(0.3);
+				rnorm[ix] = rgen_.signed_rand_vector();
+				float *const r(rvals.data() + 5*ix);
+				UNROLL_3X(r[i_] = rgen_.rand_float();) // color
+				r[3] = rgen_.randd(); // length
+				r[4] = rgen_.randd(); // width
 			}
 		}
 	}
-	assert(bix+1 < vbo_offsets[0].size());
-	vbo_offsets[0][bix+1] = grass.size(); // end of block/beginning of next block
+	assert(ix == num_blades);
+	// pass 2: per-blade math over the arrays with no RNG dependencies; no mesh normal
+	blade_color_t const bcolor(TT_GRASS_COLOR_SCALE);
+	grass_.reserve(grass_.size() + num_blades);
+
+	for (unsigned i = 0; i < num_blades; ++i) {
+		float const *const r(rvals.data() + 5*i);
+		vector3d const dir((plus_z + rdir[i]).get_norm());
+		vector3d const norm(cross_product(dir, rnorm[i]).get_norm());
+		unsigned char color[3] = {};
+		bcolor.gen(r, color);
+		float const length(grass_length*(0.7 + 0.6*r[3])), width(grass_width*(0.7 + 0.6*r[4]));
+		grass_.emplace_back(pos[i], dir*length, norm, color, width, 0);
+	}
 }
 
 
-void grass_tile_manager_t::gen_lod_block(unsigned bix, unsigned lod) {
+void grass_tile_manager_t::gen_lod_block(unsigned bix, unsigned lod, vector<grass_t> &grass_) const { // appends merged blades to grass_
 
-	if (lod == 0) {
-		gen_block(bix);
-		return;
-	}
-	assert(bix+1 < vbo_offsets[lod].size());
+	assert(lod > 0);
+	assert(bix+1 < vbo_offsets[lod-1].size());
 	unsigned const search_dist(1*grass_density/pow(1.5f, float(lod-1))); // enough for one cell (assumes grass blades scale down with LOD by at least 1.5x)
 	unsigned const start_ix(vbo_offsets[lod-1][bix]), end_ix(vbo_offsets[lod-1][bix+1]); // from previous LOD
 	float const dmax(2.5*grass_width*(1ULL << lod)), dkeep(0.2*grass_width*(1ULL << lod)), dkeep_sq(dkeep*dkeep);
@@ -169,7 +216,7 @@ void grass_tile_manager_t::gen_lod_block(unsigned bix, unsigned lod) {
 	
 	for (unsigned i = start_ix; i < end_ix; ++i) {
 		if (used[i-start_ix]) continue; // already used
-		grass.push_back(grass[i]); // seed with an existing grass blade
+		grass_.push_back(grass[i]); // seed with an existing grass blade
 		float dmin_sq(dmax*dmax); // start at max allowed dist
 		unsigned merge_ix(i); // start at ourself (invalid)
 		unsigned const end_val(min(i+search_dist, end_ix));
@@ -187,11 +234,10 @@ void grass_tile_manager_t::gen_lod_block(unsigned bix, unsigned lod) {
 		if (merge_ix > i) {
 			assert(merge_ix < grass.size());
 			assert(merge_ix-start_ix < used.size());
-			grass.back().merge(grass[merge_ix]);
+			grass_.back().merge(grass[merge_ix]);
 			used[merge_ix-start_ix] = 1;
 		}
 	} // for i
-	vbo_offsets[lod][bix+1] = grass.size(); // end of current LOD block/beginning of next LOD block
 }
 
 
@@ -205,13 +251,8 @@ void grass_tile_manager_t::upload_data() {
 
 	if (empty()) return;
 	RESET_TIME;
-	vector<grass_data_t> data(3*size()); // 3 vertices per grass blade
-
-	for (unsigned i = 0, ix = 0; i < size(); ++i) {
-		vector3d const &norm(plus_z); // use grass normal? 2-sided lighting? generate normals in vertex shader?
-		//vector3d const &norm(grass[i].n);
-		add_to_vbo_data(grass[i], data, ix, norm);
-	}
+	vector<grass_data_t> data;
+	create_vbo_data(data);
 	upload_to_vbo(vbo, data, 0, 1);
 	data_valid = 1;
 	PRINT_TIME("Grass Tile Upload");
@@ -224,12 +265,28 @@ void grass_tile_manager_t::gen_grass() {
 	assert(NUM_GRASS_LODS > 0);
 	assert((MESH_X_SIZE % GRASS_BLOCK_SZ) == 0 && (MESH_Y_SIZE % GRASS_BLOCK_SZ) == 0);
 	grass.reserve(5*grass_density*GRASS_BLOCK_SZ*GRASS_BLOCK_SZ*num_rnd_grass_blocks/2);
+	vector<vector<grass_t>> block_grass(num_rnd_grass_blocks); // blocks are independent within a LOD, and each LOD only reads the previous one
 
 	for (unsigned lod = 0; lod < NUM_GRASS_LODS; ++lod) {
 		vbo_offsets[lod].resize(num_rnd_grass_blocks+1);
 		vbo_offsets[lod][0] = grass.size(); // start
-		for (unsigned i = 0; i < num_rnd_grass_blocks; ++i) {gen_lod_block(i, lod);}
-	}
+
+#pragma omp parallel for schedule(dynamic,1)
+		for (int i = 0; i < (int)num_rnd_grass_blocks; ++i) {
+			block_grass[i].clear();
+
+			if (lod == 0) {
+				rand_gen_pregen_t rgen_;
+				rgen_.set_state(845631*(i+1), 667239); // unique state for each block
+				gen_block(block_grass[i], rgen_);
+			}
+			else {gen_lod_block(i, lod, block_grass[i]);}
+		}
+		for (unsigned i = 0; i < num_rnd_grass_blocks; ++i) {
+			vector_add_to(block_grass[i], grass);
+			vbo_offsets[lod][i+1] = grass.size(); // end of block/beginning of next block
+		}
+	} // for lod
 	cout << "Grass Blades: " << size() << ", Cap: " << grass.capacity()
 		 << ", CPU Mem: " << get_cont_mem_usage(grass) << ", GPU Mem: " << 3*size()*sizeof(grass_data_t) << endl;
 	PRINT_TIME("Grass Tile Gen");
@@ -768,19 +825,20 @@ void flower_manager_t::create_verts_range(vector<vert_norm_comp_color> &verts, u
 
 	assert(start < end && end <= size());
 	verts.resize(4*(end - start));
-	unsigned ix(0);
 
-	for (auto i = flowers.begin()+start; i != flowers.begin()+end; ++i) {
+#pragma omp parallel for schedule(static) if (end - start > 4096)
+	for (int fix = start; fix < (int)end; ++fix) { // each flower writes its own 4 verts
+		flower_t const &f(flowers[fix]);
 		vector3d dirs[2];
-		get_ortho_vectors(i->normal, dirs);
-		vector3d const v1(i->radius*dirs[0]), v2(i->radius*dirs[1]);
+		get_ortho_vectors(f.normal, dirs);
+		vector3d const v1(f.radius*dirs[0]), v2(f.radius*dirs[1]);
 		color_wrapper cw;
-		cw.set_c4(i->color);
-		norm_comp const n(i->normal);
-		point const pts[4] = {(i->pos - v1 - v2), (i->pos + v1 - v2), (i->pos + v1 + v2), (i->pos - v1 + v2)};
-		UNROLL_4X(verts[ix++] = vert_norm_comp_color(vert_norm_comp(pts[i_], n), cw);)
+		cw.set_c4(f.color);
+		norm_comp const n(f.normal);
+		point const pts[4] = {(f.pos - v1 - v2), (f.pos + v1 - v2), (f.pos + v1 + v2), (f.pos - v1 + v2)};
+		vert_norm_comp_color *const v(verts.data() + 4*(fix - start));
+		UNROLL_4X(v[i_] = vert_norm_comp_color(vert_norm_comp(pts[i_], n), cw);)
 	}
-	assert(ix == verts.size());
 }
 
 void flower_manager_t::upload_range(unsigned start, unsigned end) const {
@@ -32,6 +32,11 @@ protected:
 			: p(p_), dir(dir_), n(n_), on_mesh(on_mesh_), w(w_) {c[0] = c_[0]; c[1] = c_[1]; c[2] = c_[2];}
 		void merge(grass_t const &g);
 	};
+	struct blade_color_t { // terms that are constant across a batch of blades; each color channel is a linear function of one random value
+		float add[3], mul[3], dead[3], dead_scale;
+		blade_color_t(float cscale);
+		void gen(float const rvals[3], unsigned char color[3]) const;
+	};
 
 	vector<grass_t> grass;
 	bool data_valid=0;
@@ -49,6 +54,7 @@ public:
 	void add_grass_blade(point const &pos, float cscale, bool on_mesh) {add_grass_blade_int(pos, cscale, on_mesh, grass, rgen);}
 	void create_new_vbo();
 	void add_to_vbo_data(grass_t const &g, vector<grass_data_t> &data, unsigned &ix, vector3d const &norm) const;
+	void create_vbo_data(vector<grass_data_t> &data) const;
 	void scale_grass(float lscale, float wscale);
 	void begin_draw() const;
 	void end_draw() const;
@@ -60,13 +66,13 @@ class grass_tile_manager_t : public grass_manager_t {
 	vector<unsigned> vbo_offsets[NUM_GRASS_LODS];
 	unsigned start_render_ix=0, end_render_ix=0;
 
-	void gen_block(unsigned bix);
-	void gen_lod_block(unsigned bix, unsigned lod);
+	void gen_block(vector<grass_t> &grass_, rand_gen_pregen_t &rgen_) const;
+	void gen_lod_block(unsigned bix, unsigned lod, vector<grass_t> &grass_) const;
 public:
 	void clear();
 	size_t get_gpu_mem() const {return (vbo ? 3*size()*sizeof(grass_data_t) : 0);}
 	void upload_data();
-	void gen_grass();
+	void gen_grass(); // no GL calls, can be run on a worker thread; upload_data() must be called on the main thread
 	void update();
 	unsigned render_block(unsigned block_ix, unsigned lod, float density=1.0, unsigned num_instances=1, bool use_tess=0);
 };
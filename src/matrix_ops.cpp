@@ -41,7 +41,8 @@ vector3d  **surface_normals = NULL;
 vector3d  **vertex_normals = NULL;
 float     **charge_dist = NULL;
 float     **surface_damage = NULL;
-ripple_state **ripples = NULL;
+float     **ripple_rval = NULL; // ripple wave height
+float     **ripple_acc = NULL; // ripple wave velocity
 unsigned char **mesh_draw = NULL;
 unsigned char **water_enabled = NULL;
 unsigned char **flower_weight = NULL;
@@ -109,7 +110,8 @@ void alloc_matrices() { // called at the beginning of main()
 	matrix_gen_2d(vertex_normals);
 	matrix_gen_2d(charge_dist);
 	matrix_gen_2d(surface_damage);
-	matrix_gen_2d(ripples);
+	matrix_gen_2d(ripple_rval);
+	matrix_gen_2d(ripple_acc);
 	matrix_gen_2d(wat_surf_normals, MESH_X_SIZE, 2); // only two rows
 	matrix_alloced = 1;
 }
@@ -133,7 +135,8 @@ void delete_matrices() { // called at the end of main()
 	matrix_delete_2d(vertex_normals);
 	matrix_delete_2d(charge_dist);
 	matrix_delete_2d(surface_damage);
-	matrix_delete_2d(ripples);
+	matrix_delete_2d(ripple_rval);
+	matrix_delete_2d(ripple_acc);
 	matrix_alloced = 0;
 }
 
@@ -144,7 +147,8 @@ void compute_matrices() {
 	reset_other_objects_status();
 	matrix_clear_2d(accumulation_matrix);
 	matrix_clear_2d(surface_damage);
-	matrix_clear_2d(ripples);
+	matrix_clear_2d(ripple_rval);
+	matrix_clear_2d(ripple_acc);
 	matrix_clear_2d(spillway_matrix);
 	remove_all_coll_obj();
 
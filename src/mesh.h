@@ -11,11 +11,6 @@ float const MESH_MIN_Z = -1.0E6; // special mesh height that is guaranteed to be
 extern float sthresh[2][2];
 
 
-struct ripple_state {
-	float rval, acc;
-};
-
-
 class compute_shader_t;
 class compute_shader_comp_t;
 
@@ -113,7 +108,8 @@ extern vector3d  **surface_normals;
 extern vector3d  **vertex_normals;
 extern float     **charge_dist;
 extern float     **surface_damage;
-extern ripple_state **ripples;
+extern float     **ripple_rval;
+extern float     **ripple_acc;
 extern unsigned char **mesh_draw;
 extern unsigned char **water_enabled;
 extern unsigned char **flower_weight;
@@ -57,9 +57,9 @@ void draw_transparent_city_bldg_geom(int reflection_pass, vector3d const &xlate)
 
 // ************ texture_manager ************
 
-size_t texture_manager::tot_textures = 0;
-size_t texture_manager::tot_gpu_mem  = 0;
-size_t texture_manager::tot_cpu_mem  = 0;
+std::atomic<size_t> texture_manager::tot_textures(0);
+std::atomic<size_t> texture_manager::tot_gpu_mem (0);
+std::atomic<size_t> texture_manager::tot_cpu_mem (0);
 
 unsigned texture_manager::create_texture(string const &fn, bool is_alpha_mask, bool verbose, bool invert_alpha,
 	bool wrap, bool mirror, bool force_grayscale, bool is_nm, bool invert_y, bool no_cache, bool load_now)
@@ -136,7 +136,7 @@ bool texture_manager::ensure_texture_loaded(int tid, bool is_bump) {
 	}
 	if (is_bump && t.ncolors == 1) {t.make_normal_map();} // make RGB normal map from grayscale bump map
 	t.init(); // must be after alpha copy
-	tot_cpu_mem += t.get_cpu_mem(); // not thread safe?
+	tot_cpu_mem += t.get_cpu_mem();
 	return 1;
 }
 
@@ -146,7 +146,7 @@ void texture_manager::post_load_texture_from_memory(int tid) { // called on inte
 	t.expand_grayscale_to_rgb();
 	t.fix_word_alignment(); // untested
 	t.init(); // calls calc_color()
-	tot_cpu_mem += t.get_cpu_mem(); // not thread safe?
+	tot_cpu_mem += t.get_cpu_mem();
 }
 
 void texture_manager::bind_alpha_channel_to_texture(int tid, int alpha_tid) {
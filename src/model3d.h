@@ -10,6 +10,7 @@
 #include "gl_ext_arb.h"
 
 #include <unordered_map>
+#include <atomic>
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/quaternion.hpp>
@@ -444,7 +445,7 @@ class texture_manager {
 		bool operator< (tex_work_item_t const &w) const {return ((tid == w.tid) ? (is_nm < w.is_nm) : (tid < w.tid));}
 		bool operator==(tex_work_item_t const &w) const {return (tid == w.tid && is_nm == w.is_nm);}
 	};
-	static size_t tot_textures, tot_gpu_mem, tot_cpu_mem; // summed across all texture managers
+	static std::atomic<size_t> tot_textures, tot_gpu_mem, tot_cpu_mem; // summed across all texture managers; atomic because models may be loaded on background threads
 protected:
 	deque<texture_t> textures;
 	string_map_t tex_map; // maps texture filenames to texture indexes
@@ -754,6 +755,8 @@ void write_models_to_cobj_file(std::ostream &out);
 void adjust_zval_for_model_coll(point &pos, float radius, float mesh_zval, float step_height=0.0);
 void check_legal_movement_using_model_coll(point const &prev, point &cur, float radius=0.0);
 
+int load_model_file_into(string const &filename, model3d &cur_model, geom_xform_t const &xf, string const &anim_name,
+	int recalc_normals, bool write_file, bool verbose, uint64_t rev_winding_mask=0);
 bool load_model_file(string const &filename, model3ds &models, geom_xform_t const &xf, string const &anim_name, int def_tid, colorRGBA const &def_c,
 	int reflective, float metalness, float lod_scale, int recalc_normals, int group_cobjs_level, bool write_file, bool verbose, uint64_t rev_winding_mask=0);
 bool read_model_file(string const &filename, vector<coll_tquad> *ppts, geom_xform_t const &xf, int def_tid, colorRGBA const &def_c,
@@ -9,6 +9,7 @@
 #include <stdint.h>
 #include <algorithm> // for transform()
 #include <cctype> // for tolower()
+#include <omp.h>
 #include "fast_atof.h"
 #include "format_text.h"
 
@@ -35,6 +36,23 @@ void base_file_reader::close_file() {
 	if (fp) {checked_fclose(fp);}
 	fp = NULL;
 }
+bool base_file_reader::load_entire_file() { // replaces the streaming buffer with the contents of the entire file
+	assert(fp && file_buf_pos == 0 && file_buf_end == 0); // must be called right after open_file()
+	if (fseek(fp, 0, SEEK_END) != 0) return 0;
+	long long const file_size(ftell(fp));
+	if (file_size < 0 || fseek(fp, 0, SEEK_SET) != 0) return 0;
+
+	if (file_size >= (long long)UINT_MAX) {
+		cerr << "Error: File " << filename << " is too large to read into memory: " << file_size << " bytes" << endl;
+		return 0;
+	}
+	delete [] file_buf;
+	file_buf = new char[max(file_size, 1LL)];
+	file_buf_end = (unsigned)fread(file_buf, 1, file_size, fp);
+	if (file_buf_end != file_size) {cerr << "Error reading file " << filename << endl; return 0;}
+	whole_file_loaded = 1;
+	return 1;
+}
 
 bool base_file_reader::read_int(int &v) {
 	bool first_char(1), is_neg(0);
@@ -193,6 +211,253 @@ public:
 };
 
 
+// ************************************************
+
+// Parallel OBJ line parsing: the entire file is read into memory, split into line aligned chunks, and the v/vt/vn/f lines in each chunk are
+// parsed on multiple threads ahead of the serial reader; the serial reader then consumes these results in file order. The parsing functions
+// below follow the exact rules of base_file_reader/object_file_reader, and a pre-parsed line is only used if the serial reader reaches
+// the same file position, so the result is identical to a serial read.
+
+enum {OBJ_LINE_NONE=0, OBJ_LINE_V, OBJ_LINE_VT, OBJ_LINE_VN, OBJ_LINE_F};
+unsigned const OBJ_MAX_TOKEN_CHARS = 1024; // same as base_file_reader::MAX_CHARS
+
+unsigned get_obj_line_type(char const *s) {
+	if (s[0] == 'f' && s[1] == 0) return OBJ_LINE_F;
+	if (s[0] != 'v') return OBJ_LINE_NONE;
+	if (s[1] == 0  ) return OBJ_LINE_V;
+	if (s[2] != 0  ) return OBJ_LINE_NONE;
+	if (s[1] == 't') return OBJ_LINE_VT;
+	if (s[1] == 'n') return OBJ_LINE_VN;
+	return OBJ_LINE_NONE;
+}
+
+struct obj_face_vert_t {
+	int vix=0, tix=0, nix=0;
+	bool has_tix=0, has_nix=0;
+};
+struct obj_line_t {
+	unsigned start=0, end=0; // file positions after the line's keyword and after its data
+	unsigned type=OBJ_LINE_NONE, fv_start=0, fv_count=0; // fv_* are for faces only
+	int color_ret=0; // for vertices only: 0=no color, 1=color, 2=error
+	bool valid=0;
+	point p; // vertex, tex coord, or normal
+	colorRGB color;
+};
+struct obj_parse_block_t {
+	vector<obj_line_t> lines;
+	vector<obj_face_vert_t> fverts;
+	void clear() {lines.clear(); fverts.clear();}
+};
+
+class obj_mem_reader_t { // in-memory equivalent of base_file_reader + object_file_reader parsing
+	char const *buf;
+	unsigned end;
+	char token[OBJ_MAX_TOKEN_CHARS];
+
+	static bool fast_isspace(char c) {return (c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r');}
+	static bool fast_isdigit(char c) {return (c >= '0' && c <= '9');}
+	char get_char() {return ((pos == end) ? char(EOF) : buf[pos++]);}
+	void unget_last_char(char c) {
+		if (c == EOF) return; // can't unget EOF
+		assert(pos > 0);
+		--pos;
+	}
+public:
+	unsigned pos;
+
+	obj_mem_reader_t(char const *buf_, unsigned pos_, unsigned end_) : buf(buf_), end(end_), pos(pos_) {}
+
+	bool read_int(int &v) {
+		bool first_char(1), is_neg(0);
+		v = 0;
+
+		while (1) {
+			char const c(get_char());
+			if (first_char && fast_isspace(c)) continue; // skip leading whitespace
+			if (first_char && c == '-') {is_neg = 1; first_char = 0; continue;} // negative
+			if (!fast_isdigit(c)) {unget_last_char(c); break;} // non-integer character, unget it and finish
+			v = 10*v + int(c - '0');
+			first_char = 0;
+		}
+		if (first_char) return 0; // no integer characters were read
+		if (is_neg) {v = -v;}
+		return 1;
+	}
+	bool read_string(char *s, unsigned max_len) {
+		unsigned ix(0);
+			
+		while (1) {
+			if (ix+1 >= max_len) return 0; // buffer overrun
+			char const c(get_char());
+			if (c == EOF) break;
+			if (fast_isspace(c)) {
+				if (ix == 0) continue; // leading whitespace
+				if (c == '\n') {unget_last_char(c);} // preserve the newline
+				break; // trailing whitespace
+			}
+			s[ix++] = c;
+		}
+		if (ix == 0) return 0; // nothing was read
+		s[ix] = 0; // add null terminator
+		return 1;
+	}
+	bool read_float(float &val) {
+		unsigned ix(0);
+
+		while (1) {
+			if (ix+1 >= OBJ_MAX_TOKEN_CHARS) return 0; // buffer overrun
+			char const c(get_char());
+			if (c == EOF) break;
+			if (fast_isspace(c)) {if (ix == 0) continue; else break;} // leading/trailing whitespace
+
+			if (ix == 0 && !fast_isdigit(c) && c != '.' && c != '-') { // not a fp number
+				unget_last_char(c);
+				return 0;
+			}
+			token[ix++] = c;
+		}
+		token[ix] = 0; // add null terminator
+		val = Assimp::fast_atof(token);
+		return 1;
+	}
+	bool read_point(point &p, unsigned req_num=3) {
+		for (unsigned i = 0; i < 3; ++i) {
+			if (!read_float(p[i])) {return ((i >= req_num) ? 1 : 0);} // success if we read enough values
+		}
+		return 1;
+	}
+	int read_optional_color_RGB(colorRGB &c) { // return value: 0=no color read, 1=color read, 2=error
+		float val(0.0);
+		if (!read_float(val)) return 0; // no more numbers to read
+		c.R = val;
+		return ((read_float(c.G) && read_float(c.B)) ? 1 : 2); // success or error
+	}
+	void read_face(vector<obj_face_vert_t> &fverts) {
+		obj_face_vert_t fv;
+
+		while (read_int(fv.vix)) { // read vertex index
+			fv.has_tix = fv.has_nix = 0;
+			char const c(get_char());
+
+			if (c == '/') {
+				fv.has_tix = read_int(fv.tix); // read text coord index
+				char const c2(get_char());
+				if (c2 == '/') {fv.has_nix = read_int(fv.nix);} // read normal index
+				else {unget_last_char(c2);}
+			}
+			else {unget_last_char(c);}
+			fverts.push_back(fv);
+		} // end while
+	}
+	void parse_line(unsigned type, obj_parse_block_t &out) { // parses the data following the line's keyword at the current position
+		obj_line_t line;
+		line.start = pos;
+		line.type  = type;
+
+		switch (type) {
+		case OBJ_LINE_V:
+			line.valid = read_point(line.p);
+			if (line.valid) {line.color_ret = read_optional_color_RGB(line.color);}
+			break;
+		case OBJ_LINE_VT: line.valid = read_point(line.p, 2); break;
+		case OBJ_LINE_VN: line.valid = read_point(line.p   ); break;
+		case OBJ_LINE_F:
+			line.fv_start = (unsigned)out.fverts.size();
+			read_face(out.fverts);
+			line.fv_count = (unsigned)out.fverts.size() - line.fv_start;
+			line.valid    = 1;
+			break;
+		default: assert(0);
+		}
+		line.end = pos;
+		out.lines.push_back(line);
+	}
+	void parse_lines(unsigned line_start, unsigned chunk_end, obj_parse_block_t &out) { // parse v/vt/vn/f lines starting in [line_start, chunk_end)
+		while (line_start < chunk_end) {
+			unsigned p(line_start);
+			while (p < end && buf[p] != '\n' && fast_isspace(buf[p])) {++p;} // skip leading whitespace on this line
+
+			if (p < end && buf[p] != '\n') {
+				pos = p;
+
+				if (read_string(token, OBJ_MAX_TOKEN_CHARS)) {
+					unsigned const type(get_obj_line_type(token));
+					if (type != OBJ_LINE_NONE) {parse_line(type, out);}
+				}
+			}
+			char const *const nl((p < end) ? (char const *)memchr(buf+p, '\n', end-p) : nullptr);
+			if (nl == nullptr) break; // last line
+			line_start = unsigned(nl - buf) + 1;
+		} // end while
+	}
+};
+
+class obj_line_parser_t {
+	char const *buf=nullptr;
+	unsigned buf_end=0, parsed_end=0, cur_block=0, cur_line=0;
+	vector<obj_parse_block_t> blocks; // for the current window
+	obj_parse_block_t serial_block; // for lines that weren't parsed ahead
+
+	unsigned next_line_start(unsigned pos) const {
+		if (pos >= buf_end) return buf_end;
+		char const *const nl((char const *)memchr(buf+pos, '\n', buf_end-pos));
+		return (nl ? unsigned(nl - buf) + 1 : buf_end);
+	}
+	void parse_next_window() {
+		unsigned const window_size = (1U << 24); // 16MB
+		unsigned const window_end(next_line_start(parsed_end + min(window_size, buf_end - parsed_end) - 1));
+		unsigned const num_chunks(4*max(1, omp_get_max_threads())), chunk_size(max(1U, (window_end - parsed_end)/num_chunks));
+		vector<unsigned> bounds(1, parsed_end);
+
+		for (unsigned c = 1; c < num_chunks && bounds.back() < window_end; ++c) { // line aligned chunk boundaries
+			bounds.push_back(min(window_end, next_line_start(bounds.back() + chunk_size - 1)));
+		}
+		if (bounds.back() < window_end) {bounds.push_back(window_end);}
+		blocks.resize(bounds.size() - 1);
+#pragma omp parallel for schedule(dynamic, 1)
+		for (int c = 0; c < (int)blocks.size(); ++c) {
+			blocks[c].clear();
+			obj_mem_reader_t(buf, bounds[c], buf_end).parse_lines(bounds[c], bounds[c+1], blocks[c]);
+		}
+		parsed_end = window_end;
+		cur_block  = cur_line = 0;
+	}
+	obj_line_t const *find_parsed_line(unsigned pos, obj_face_vert_t const *&fverts) {
+		while (1) {
+			for (; cur_block < blocks.size(); ++cur_block, cur_line = 0) {
+				vector<obj_line_t> const &lines(blocks[cur_block].lines);
+				while (cur_line < lines.size() && lines[cur_line].start < pos) {++cur_line;}
+				if (cur_line == lines.size()) continue; // no more lines in this block
+				if (lines[cur_line].start != pos) return nullptr; // not a parsed line
+				fverts = blocks[cur_block].fverts.data();
+				return &lines[cur_line];
+			}
+			if (pos < parsed_end || parsed_end >= buf_end) return nullptr; // no parsed line at this position
+			parse_next_window();
+		} // end while
+	}
+public:
+	void init(char const *buf_, unsigned buf_end_, bool parse_ahead) {
+		buf        = buf_;
+		buf_end    = buf_end_;
+		parsed_end = (parse_ahead ? 0 : buf_end);
+	}
+	// returns the parsed data for a line of this type whose keyword ends at pos, and updates pos to the end of the line's data
+	obj_line_t const &get_line(unsigned type, unsigned &pos, unsigned cur_end, obj_face_vert_t const *&fverts) {
+		obj_line_t const *line(find_parsed_line(pos, fverts));
+
+		if (line == nullptr || line->type != type) { // parse it here
+			serial_block.clear();
+			obj_mem_reader_t(buf, pos, cur_end).parse_line(type, serial_block);
+			line   = &serial_block.lines.back();
+			fverts = serial_block.fverts.data();
+		}
+		pos = line->end;
+		return *line;
+	}
+};
+
+
 // ************************************************
 
 
@@ -500,6 +765,11 @@ public:
 		if (!open_file(1)) return 0; // binary mode is faster
 		cout << "Reading object file " << filename << endl;
 		RESET_TIME;
+		if (!load_entire_file()) {cerr << "Error reading object file " << filename << endl; return 0;}
+		unsigned const min_parse_ahead_size = (1 << 22); // 4MB; smaller files are parsed serially
+		obj_line_parser_t line_parser;
+		line_parser.init(file_buf, file_buf_end, (file_buf_end >= min_parse_ahead_size));
+		obj_face_vert_t const *fverts(nullptr);
 		unsigned const block_size = (1 << 18); // 256K
 		int cur_mat_id(-1);
 		unsigned smoothing_group(0), prev_smoothing_group(0), num_faces(0), num_objects(0), num_groups(0), obj_group_id(0);
@@ -543,32 +813,24 @@ public:
 				pb.polys.push_back(poly_header_t(cur_mat_id, obj_group_id));
 				unsigned &npts(pb.polys.back().npts);
 				unsigned const pix((unsigned)pb.pts.size()), pts_start(pb.pts.size());
-				int vix(0), tix(0), nix(0);
+				obj_line_t const &line(line_parser.get_line(OBJ_LINE_F, file_buf_pos, file_buf_end, fverts));
 
-				while (read_int(vix)) { // read vertex index
-					normalize_index(vix, (unsigned)v.size());
-					vntc_ix_t vntc_ix(vix, 0, 0);
-					int const c(get_next_char());
+				for (unsigned i = 0; i < line.fv_count; ++i) {
+					obj_face_vert_t fv(fverts[line.fv_start + i]);
+					normalize_index(fv.vix, (unsigned)v.size());
+					vntc_ix_t vntc_ix(fv.vix, 0, 0);
 
-					if (c == '/') {
-						if (read_int(tix)) { // read text coord index
-							normalize_index(tix, (unsigned)tc.size()-1); // account for tc[0]
-							vntc_ix.tix = tix+1; // account for tc[0]
-						}
-						int const c2(get_next_char());
-
-						if (c2 == '/') {
-							if (read_int(nix) && !recalc_normals) { // read normal index
-								normalize_index(nix, (unsigned)n.size()-1); // account for n[0]
-								vntc_ix.nix = nix+1; // account for n[0]
-							} // else the normal will be recalculated later
-						}
-						else {unget_last_char(c2);}
+					if (fv.has_tix) { // read text coord index
+						normalize_index(fv.tix, (unsigned)tc.size()-1); // account for tc[0]
+						vntc_ix.tix = fv.tix+1; // account for tc[0]
 					}
-					else {unget_last_char(c);}
+					if (fv.has_nix && !recalc_normals) { // read normal index
+						normalize_index(fv.nix, (unsigned)n.size()-1); // account for n[0]
+						vntc_ix.nix = fv.nix+1; // account for n[0]
+					} // else the normal will be recalculated later
 					pb.pts.push_back(vntc_ix);
 					++npts;
-				} // end while vertex
+				} // end for vertex
 				if (npts < 3) {
 					if (!had_npts_error) {cerr << "Error near line " << approx_line << ": face has only " << npts << " vertices." << endl; had_npts_error = 1;}
 					pb.pts.resize(pts_start);
@@ -607,36 +869,38 @@ public:
 				}
 			}
 			else if (strcmp(s, "v") == 0) { // vertex
-				v.push_back(point());
+				obj_line_t const &line(line_parser.get_line(OBJ_LINE_V, file_buf_pos, file_buf_end, fverts));
+				v.push_back(line.p);
 				if (recalc_normals) {vn.push_back(counted_normal());} // vertex normal
 			
-				if (!read_point(v.back())) {
+				if (!line.valid) {
 					cerr << "Error reading vertex from object file " << filename << " near line " << approx_line << endl;
 					return 0;
 				}
-				colorRGB color;
-				int const color_ret(read_optional_color_RGB(color));
+				int const color_ret(line.color_ret);
 				if (color_ret == 2) {cerr << "Error reading vertex color from object file " << filename << " near line " << approx_line << endl; return 0;}
 				else if (color_ret == 1) {
 					if (colors.empty()) {colors.resize(v.size()-1, WHITE);} // pad colors up to this point with white
-					colors.push_back(color);
+					colors.push_back(line.color);
 				}
 				else if (!colors.empty()) {colors.push_back(WHITE);} // color not specified, and in colors mode, pad with white
 				xf.xform_pos(v.back());
 			}
 			else if (strcmp(s, "vt") == 0) { // tex coord
-				point tc3d;
+				obj_line_t const &line(line_parser.get_line(OBJ_LINE_VT, file_buf_pos, file_buf_end, fverts));
+				point const &tc3d(line.p);
 			
-				if (!read_point(tc3d, 2)) {
+				if (!line.valid) {
 					cerr << "Error reading texture coord from object file " << filename << " near line " << approx_line << endl;
 					return 0;
 				}
 				tc.push_back(point2d<float>(tc3d.x, tc3d.y)); // discard tc3d.z
 			}
 			else if (strcmp(s, "vn") == 0) { // normal
-				vector3d normal;
+				obj_line_t const &line(line_parser.get_line(OBJ_LINE_VN, file_buf_pos, file_buf_end, fverts));
+				vector3d normal(line.p);
 			
-				if (!read_point(normal)) {
+				if (!line.valid) {
 					cerr << "Error reading normal from object file " << filename << " near line " << approx_line << endl;
 					return 0;
 				}
@@ -794,36 +1058,45 @@ bool read_assimp_model(string const &filename, model3d &model, geom_xform_t cons
 bool const ALWAYS_USE_ASSIMP = 0;
 
 // recalc_normals: 0=no, 1=yes, 2=face_weight_avg
-bool load_model_file(string const &filename, model3ds &models, geom_xform_t const &xf, string const &anim_name, int def_tid, colorRGBA const &def_c,
-	int reflective, float metalness, float lod_scale, int recalc_normals, int group_cobjs_level, bool write_file, bool verbose, uint64_t rev_winding_mask)
+// returns 0 on read failure, 1 on success, and 2 if the model was read but writing the model3d file failed
+// Note: only uses cur_model and its texture manager, so this can be called on a background thread if the texture manager isn't shared
+int load_model_file_into(string const &filename, model3d &cur_model, geom_xform_t const &xf, string const &anim_name,
+	int recalc_normals, bool write_file, bool verbose, uint64_t rev_winding_mask)
 {
-	if (filename.empty()) return 0; // can't be loaded
 	string const ext(get_file_extension(filename, 0, 1));
-	models.push_back(model3d(filename, models.tmgr, def_tid, def_c, reflective, metalness, lod_scale, recalc_normals, group_cobjs_level));
-	model3d &cur_model(models.back());
 
 	if (!ALWAYS_USE_ASSIMP && ext == "3ds") {
-		if (!read_3ds_file_model(filename, cur_model, xf, recalc_normals, verbose)) {models.pop_back(); return 0;} // recalc_normals is always true
-		//if (write_file && !write_model3d_file(filename, cur_model)) return 0; // Note: doesn't work because there's no mtllib file
+		if (!read_3ds_file_model(filename, cur_model, xf, recalc_normals, verbose)) return 0; // recalc_normals is always true
+		//if (write_file && !write_model3d_file(filename, cur_model)) return 2; // Note: doesn't work because there's no mtllib file
 	}
 	else if (ext == "model3d") {
 		//assert(xf == geom_xform_t()); // xf is ignored, assumed to be already applied; use transforms with loaded model3d files
-		if (!object_file_reader_model(filename, cur_model).load_from_model3d_file(verbose)) {models.pop_back(); return 0;}
+		if (!object_file_reader_model(filename, cur_model).load_from_model3d_file(verbose)) return 0;
 	}
 	else if (!ALWAYS_USE_ASSIMP && ext == "obj") {
 		check_obj_file_ext(filename, ext);
 		//test_other_obj_loader(filename); // placeholder for testing other object file loaders (tinyobjloader, assimp, etc.)
-		if (!object_file_reader_model(filename, cur_model).read(xf, recalc_normals, verbose)) {models.pop_back(); return 0;}
-		if (write_file && !write_model3d_file(filename, cur_model)) return 0; // don't need to pop the model
+		if (!object_file_reader_model(filename, cur_model).read(xf, recalc_normals, verbose)) return 0;
+		if (write_file && !write_model3d_file(filename, cur_model)) return 2;
 	}
 	else { // not a built-in supported format, try using assimp if compiled in
-		if (!read_assimp_model(filename, cur_model, xf, anim_name, recalc_normals, verbose)) {models.pop_back(); return 0;}
+		if (!read_assimp_model(filename, cur_model, xf, anim_name, recalc_normals, verbose)) return 0;
 	}
 	if (model_mat_lod_thresh > 0.0) {cur_model.compute_area_per_tri();} // used for TT LOD/distance culling
 	cur_model.reverse_winding_order(rev_winding_mask);
 	return 1;
 }
 
+bool load_model_file(string const &filename, model3ds &models, geom_xform_t const &xf, string const &anim_name, int def_tid, colorRGBA const &def_c,
+	int reflective, float metalness, float lod_scale, int recalc_normals, int group_cobjs_level, bool write_file, bool verbose, uint64_t rev_winding_mask)
+{
+	if (filename.empty()) return 0; // can't be loaded
+	models.push_back(model3d(filename, models.tmgr, def_tid, def_c, reflective, metalness, lod_scale, recalc_normals, group_cobjs_level));
+	int const ret(load_model_file_into(filename, models.back(), xf, anim_name, recalc_normals, write_file, verbose, rev_winding_mask));
+	if (ret == 0) {models.pop_back();} // read failed; if only the write failed, we don't need to pop the model
+	return (ret == 1);
+}
+
 // Note: assimp reader not supported in this flow
 bool read_model_file(string const &filename, vector<coll_tquad> *ppts, geom_xform_t const &xf, int def_tid, colorRGBA const &def_c,
 	int reflective, float metalness, float lod_scale, bool load_models, int recalc_normals, int group_cobjs_level, bool write_file, bool verbose)
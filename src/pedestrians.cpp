@@ -2378,7 +2378,7 @@ bool ped_manager_t::draw_ped(person_base_t const &ped, shader_t &s, pos_dir_up c
 	if (is_dlight_shadows && !dist_less_than(pre_smap_player_pos, ped.pos, 0.4*def_draw_dist)) return 0; // too far from the player
 	if (is_dlight_shadows && !sphere_in_light_cone_approx   (pdu, ped.pos, 0.5*height       )) return 0;
 
-	if (ped_model_loader.num_models() == 0 || !ped_model_loader.is_model_valid(ped.model_id)) { // no model - draw as sphere
+	if (ped_model_loader.num_models() == 0 || !ped_model_loader.is_model_ready(ped.model_id, dist_sq)) { // no model or not yet loaded - draw as sphere
 		if (!pdu.sphere_visible_test(ped.pos, ped.radius)) return 0; // not visible - skip
 		if (anim_state) {anim_state->clear_animation_id(s);} // no animations for a sphere
 		begin_ped_sphere_draw(s, YELLOW, in_sphere_draw, 0);
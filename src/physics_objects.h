@@ -141,17 +141,20 @@ public:
 
 class physics_particle_manager {
 protected:
-	struct part_t { // size = 28
-		point p; // position
-		vector3d v; // velocity
-		color_wrapper c;
-
-		part_t() {}
-		part_t(point const &p_, vector3d const &v_, colorRGBA const &c_) : p(p_), v(v_) {c.set_c4(c_);}
-	};
-	vector<part_t> parts;
+	// particle data is stored as separate arrays (SoA) so that the physics loops can be vectorized
+	vector<point> pos;
+	vector<vector3d> vel;
+	vector<color_wrapper> colors;
+	vector<unsigned char> to_remove; // temporary
+
+	void add_particle(point const &p, vector3d const &v, colorRGBA const &c) {
+		pos.push_back(p);
+		vel.push_back(v);
+		colors.push_back(color_wrapper());
+		colors.back().set_c4(c);
+	}
 public:
-	void clear() {parts.clear();}
+	void clear() {pos.clear(); vel.clear(); colors.clear();}
 	void gen_particles(point const &pos, vector3d const &vadd, float vmag, float gen_radius, colorRGBA const &color, unsigned num);
 	void apply_physics(float gravity, float terminal_velocity, bool emissive=0);
 	void draw(float radius, int tid, bool emissive=0) const;
@@ -48,7 +48,7 @@ typedef vector<wpt_ix_t> waypt_adj_vect;
 
 struct waypoint_t {
 
-	bool user_placed, placed_item, goal, temp, visited=0, disabled=0, next_valid=0;
+	bool user_placed, placed_item, goal, temp, visited=0, disabled=0;
 	int came_from=-1, item_group=-1, item_ix=-1, coll_id=-1, connected_to=-1;
 	float g_score=0.0, f_score=0.0;
 	point pos;
@@ -24,7 +24,28 @@ float get_road_height();
 template <unsigned VERTS_PER_PRIM> class precip_manager_t {
 protected:
 	typedef vert_wrap_t vert_type_t;
+
+	struct hfield_cell_t { // combined occluder heights for one mesh cell, so that each particle does a single lookup
+		float surf_z=0.0, water_z=0.0, cobj_z=0.0; // surf_z = max(water_z, mesh_z); cobj_z is compared to the particle bottom
+	};
+	struct water_splash_t {
+		point pos;
+		int x, y;
+		water_splash_t(point const &pos_, int x_, int y_) : pos(pos_), x(x_), y(y_) {}
+	};
+	struct update_ctx_t { // per-thread update state; events are applied serially in chunk order after the parallel update
+		rand_gen_t rgen;
+		bool add_splashes=0;
+		vector<sphere_t> splashes;
+		vector<water_splash_t> water_splashes; // modifies water ripples, so can't be done in parallel
+		vector<pair<point, point>> cobj_splash_lines, near_lines;
+		vector<vert_color> pts;
+
+		void clear() {splashes.clear(); water_splashes.clear(); cobj_splash_lines.clear(); near_lines.clear(); pts.clear();}
+	};
 	vector<vert_type_t> verts;
+	vector<hfield_cell_t> hfield; // ground mode only
+	vector<update_ctx_t> ctxs;
 	rand_gen_t rgen; // modified in update logic
 	vector3d xlate;
 	float prev_zmin=0.0, cur_zmin=0.0, prev_zmax=0.0, cur_zmax=0.0, precip_dist=0.0;
@@ -67,13 +88,29 @@ public:
 		}
 		check_size();
 		precip_dist = precip_dist_scale*((world_mode == WMODE_GROUND) ? XY_SCENE_SIZE : TT_PRECIP_DIST);
+		if (world_mode == WMODE_GROUND) {update_hfield();}
 		//cout << "num: " << get_num_precip() << endl; // 28K .... 142K
 	}
-	point gen_pt(float zval) {
+	void update_hfield() { // water can change every frame, so this is rebuilt each update; cost is one pass over the mesh
+		hfield.resize(XY_MULT_SIZE);
+		bool const water_coll(check_water_coll && !DISABLE_WATER && (display_mode & 0x04));
+		float const no_coll_z(-FAR_DISTANCE);
+
+#pragma omp parallel for schedule(static,16)
+		for (int y = 0; y < MESH_Y_SIZE; ++y) {
+			for (int x = 0; x < MESH_X_SIZE; ++x) {
+				hfield_cell_t &cell(hfield[y*MESH_X_SIZE + x]);
+				cell.water_z = (water_coll      ? water_matrix[y][x] : no_coll_z);
+				cell.surf_z  = max(cell.water_z, (check_mesh_coll ? mesh_height[y][x] : no_coll_z));
+				cell.cobj_z  = (check_cobj_coll ? v_collision_matrix[y][x].zmax : no_coll_z);
+			}
+		}
+	}
+	point gen_pt(float zval, rand_gen_t &rgen_) const {
 		point const camera(get_camera_pos());
 
 		while (1) {
-			vector3d const off(precip_dist*rgen.signed_rand_float(), precip_dist*rgen.signed_rand_float(), zval);
+			vector3d const off(precip_dist*rgen_.signed_rand_float(), precip_dist*rgen_.signed_rand_float(), zval);
 			if (off.x*off.x + off.y*off.y < precip_dist*precip_dist) {return (vector3d(camera.x, camera.y, 0.0) + off);}
 		}
 		return zero_vector; // never gets here
@@ -82,59 +119,77 @@ public:
 		point const camera(get_camera_pos());
 		return (pos.z < camera.z && dist_less_than(camera, pos, 5.0)); // skip splashes above the camera (assuming the surface points up)
 	}
-	void maybe_add_rain_splash(point const &pos, point const &bot_pos, float z_int, deque<sphere_t> &splashes, int x, int y, bool in_water) {
+	void maybe_add_rain_splash(point const &pos, point const &bot_pos, float z_int, update_ctx_t &ctx, int x, int y, bool in_water) const {
 		float const t((z_int - pos.z)/(bot_pos.z - pos.z));
 		point const cpos(pos + (bot_pos - pos)*t);
 		if (!camera_pdu.point_visible_test(cpos)) return;
-		if (check_splash_dist(cpos)) {splashes.push_back(sphere_t(cpos, 1.0));}
-		if (in_water && (rgen.rand() & 1)) {add_splash(cpos, x, y, 0.5, 0.01, 0, zero_vector, 0);} // 50% of the time; no droplets
+		if (check_splash_dist(cpos)) {ctx.splashes.emplace_back(cpos, 1.0);}
+		if (in_water && (ctx.rgen.rand() & 1)) {ctx.water_splashes.emplace_back(cpos, x, y);} // 50% of the time
 	}
-	bool is_bot_pos_valid(point &pos, point const &bot_pos, deque<sphere_t> *splashes=nullptr) {
+	bool is_bot_pos_valid(point &pos, point const &bot_pos, update_ctx_t &ctx, bool add_splashes) const {
+		add_splashes &= ctx.add_splashes;
+
 		if (world_mode == WMODE_GROUND) {
 			// check bottom of raindrop/snow below the mesh or top surface cobjs (even if just created)
 			if (pos.z > max(ztop, czmax))   return 1; // above mesh and cobjs, no collision possible
 			if (!is_over_mesh(pos))         return 1; // outside the simulation region, no collision possible
 			int const x(get_xpos(bot_pos.x)), y(get_ypos(bot_pos.y));
 			if (point_outside_mesh(x, y))   return 1;
+			hfield_cell_t const &cell(hfield[y*MESH_X_SIZE + x]);
 			
-			if (check_water_coll && !DISABLE_WATER && (display_mode & 0x04) && pos.z < water_matrix[y][x]) { // water collision
-				if (splashes != nullptr && (rgen.rand() & 1)) {maybe_add_rain_splash(pos, bot_pos, water_matrix[y][x], *splashes, x, y, 1);} // 50% of the time
-				return 0;
-			}
-			else if (check_mesh_coll && pos.z < mesh_height[y][x]) { // mesh collision
-				if (splashes != nullptr) {maybe_add_rain_splash(pos, bot_pos, mesh_height[y][x], *splashes, x, y, 0);} // line_intersect_mesh(pos, bot_pos, cpos);
+			if (pos.z < cell.surf_z) {
+				if (pos.z < cell.water_z) { // water collision
+					if (add_splashes && (ctx.rgen.rand() & 1)) {maybe_add_rain_splash(pos, bot_pos, cell.water_z, ctx, x, y, 1);} // 50% of the time
+				}
+				else if (add_splashes) {maybe_add_rain_splash(pos, bot_pos, cell.surf_z, ctx, x, y, 0);} // mesh collision
 				return 0;
 			}
-			else if (check_cobj_coll && bot_pos.z < v_collision_matrix[y][x].zmax) { // possible cobj collision
-				if (splashes != nullptr && check_splash_dist(bot_pos)) {
-					point cpos;
-					vector3d cnorm;
-					int cindex;
-					if (camera_pdu.point_visible_test(bot_pos) && check_coll_line_exact(pos, bot_pos, cpos, cnorm, cindex, 0.0, camera_coll_id)) {splashes->emplace_back(cpos, 1.0);}
-				}
+			if (bot_pos.z < cell.cobj_z) { // possible cobj collision
+				// the exact line query is done serially after the update, and only for the few splashes near the camera
+				if (add_splashes && check_splash_dist(bot_pos) && camera_pdu.point_visible_test(bot_pos)) {ctx.cobj_splash_lines.emplace_back(pos, bot_pos);}
 				return 0;
 			}
 		}
 		else if (world_mode == WMODE_INF_TERRAIN && !is_interior) {
+			// building footprints aren't grid aligned, so use the exact test here; it's a no-op unless the player is in a building
 			if (camera_in_building && is_pos_in_player_building(bot_pos - xlate)) return 0;
-			if (splashes != nullptr && in_city && bot_pos.z < cur_zmin) {maybe_add_rain_splash(pos, bot_pos, cur_zmin, *splashes, 0, 0, 0);} // splash on city surface
+			if (add_splashes && in_city && bot_pos.z < cur_zmin) {maybe_add_rain_splash(pos, bot_pos, cur_zmin, ctx, 0, 0, 0);} // splash on city surface
 		} // else universe/invalid
 		return 1;
 	}
-	void check_pos(point &pos, point const &bot_pos, deque<sphere_t> *splashes=nullptr) {
+	void check_pos(point &pos, point const &bot_pos, update_ctx_t &ctx) const {
 		if (pos == all_zeros) { // initial location
 			vector3d const bot_delta(bot_pos - pos);
 			
 			for (unsigned attempt = 0; attempt < 16; ++attempt) { // make 16 attempts at choosing a valid starting z-value
-				pos = gen_pt(rgen.rand_uniform(cur_zmin, cur_zmax));
-				if (is_bot_pos_valid(pos, pos+bot_delta, nullptr)) break;
+				pos = gen_pt(ctx.rgen.rand_uniform(cur_zmin, cur_zmax), ctx.rgen);
+				if (is_bot_pos_valid(pos, pos+bot_delta, ctx, 0)) break;
 			}
 		}
-		else if (pos.z < cur_zmin)                          {pos = gen_pt(cur_zmax);} // start again near the top
-		else if (!in_range(pos))                            {pos = gen_pt(pos.z   );} // move inside the range
-		else if (!is_bot_pos_valid(pos, bot_pos, splashes)) {pos = gen_pt(cur_zmax);} // start again near the top
+		else if (pos.z < cur_zmin)                        {pos = gen_pt(cur_zmax, ctx.rgen);} // start again near the top
+		else if (!in_range(pos))                          {pos = gen_pt(pos.z,    ctx.rgen);} // move inside the range
+		else if (!is_bot_pos_valid(pos, bot_pos, ctx, 1)) {pos = gen_pt(cur_zmax, ctx.rgen);} // start again near the top
 	}
 	void check_size() {verts.resize(VERTS_PER_PRIM*get_num_precip(), all_zeros);}
+
+	// calls update_prim(prim_ix, ctx) for each primitive, in parallel over fixed-size chunks;
+	// each chunk has its own RNG seeded serially from rgen, so results don't depend on the thread count or schedule
+	template<typename F> void update_prims_parallel(bool add_splashes, F const &update_prim) {
+		unsigned const CHUNK_SIZE = 4096;
+		unsigned const num_prims(verts.size()/VERTS_PER_PRIM), num_chunks((num_prims + CHUNK_SIZE - 1)/CHUNK_SIZE);
+		ctxs.resize(num_chunks);
+
+		for (auto &ctx : ctxs) {
+			ctx.clear();
+			ctx.add_splashes = add_splashes;
+			ctx.rgen.set_state(rgen.rand(), rgen.rand());
+		}
+#pragma omp parallel for schedule(dynamic,1) if (num_chunks > 1)
+		for (int c = 0; c < (int)num_chunks; ++c) {
+			unsigned const end_ix(min(num_prims, (c+1)*CHUNK_SIZE));
+			for (unsigned i = c*CHUNK_SIZE; i < end_ix; ++i) {update_prim(i, ctxs[c]);}
+		}
+	}
 };
 
 
@@ -150,9 +205,7 @@ public:
 		pre_update();
 		if (verts.empty()) return;
 		vector3d const v(get_velocity(-0.2)), vinc(v*(0.1/verts.size())), dir(0.1*v.get_norm()); // length is 0.1
-		vector3d vcur(v);
 		while (!splashes.empty() && splashes.front().radius > 4.0) {splashes.pop_front();} // remove old splashes from the front
-		deque<sphere_t> *sv(begin_motion ? &splashes : nullptr);
 		drawer.clear();
 		splash_qbd.clear();
 		get_avg_sky_color(color);
@@ -160,12 +213,24 @@ public:
 		point const camera(get_camera_pos());
 		float const width(0.002*precip_dist_scale), splash_size(2.0*width);
 
-		for (auto i = verts.begin(); i < verts.end(); i += 2) { // iterate in pairs
-			point &v1(i->v), &v2((i+1)->v);
-			check_pos(v1, v2, sv);
-			if (animate2) {v1 += vcur; vcur += vinc;}
+		update_prims_parallel(begin_motion, [&](unsigned i, update_ctx_t &ctx) {
+			point &v1(verts[2*i].v), &v2(verts[2*i+1].v);
+			check_pos(v1, v2, ctx);
+			if (animate2) {v1 += v + float(i)*vinc;} // velocity increases slightly with index
 			v2 = v1 + dir;
-			if (dist_less_than(v1, camera, 0.5) && camera_pdu.line_visible_test(v1, v2)) {drawer.add_line_as_tris(v1, v2, width, width, color, color);}
+			if (dist_less_than(v1, camera, 0.5) && camera_pdu.line_visible_test(v1, v2)) {ctx.near_lines.emplace_back(v1, v2);}
+		});
+		for (update_ctx_t const &ctx : ctxs) { // apply events in chunk order
+			for (sphere_t const &s : ctx.splashes) {splashes.push_back(s);}
+			for (water_splash_t const &s : ctx.water_splashes) {add_splash(s.pos, s.x, s.y, 0.5, 0.01, 0, zero_vector, 0);} // no droplets
+
+			for (auto const &l : ctx.cobj_splash_lines) {
+				point cpos;
+				vector3d cnorm;
+				int cindex;
+				if (check_coll_line_exact(l.first, l.second, cpos, cnorm, cindex, 0.0, camera_coll_id)) {splashes.emplace_back(cpos, 1.0);}
+			}
+			for (auto const &l : ctx.near_lines) {drawer.add_line_as_tris(l.first, l.second, width, width, color, color);}
 		}
 		// 0.08ms for default rain intensity
 		for (auto i = splashes.begin(); i != splashes.end(); ++i) { // normal always faces up
@@ -212,19 +277,19 @@ public:
 	void update() {
 		//timer_t timer("Snow Update");
 		pre_update();
-		float const vmult(0.1/verts.size());
-		vector3d const v(get_velocity(-0.02)), v_step(vmult*v);
-		vector3d v_add(v);
+		vector3d const v(get_velocity(-0.02)), v_step(v*(0.1/max(verts.size(), size_t(1))));
 		psd.clear();
 		psd.reserve_pts(size());
 		colorRGBA const color(WHITE*((world_mode == WMODE_GROUND) ? 1.5 : 1.0)*brightness); // constant
 		color_wrapper const cw(color);
 
-		for (auto i = verts.begin(); i != verts.end(); ++i) {
-			check_pos(i->v, i->v);
-			if (animate2) {i->v += v_add; v_add += v_step;}
-			psd.add_pt(vert_color(i->v, cw));
-		}
+		update_prims_parallel(0, [&](unsigned i, update_ctx_t &ctx) {
+			point &pos(verts[i].v);
+			check_pos(pos, pos, ctx);
+			if (animate2) {pos += v + float(i)*v_step;}
+			ctx.pts.emplace_back(pos, cw);
+		});
+		for (update_ctx_t const &ctx : ctxs) {psd.add_pts(ctx.pts);} // in chunk order
 	}
 	void render() const {psd.draw(WHITE_TEX, 1.0);} // unblended pixels
 	void clear() {precip_manager_t<1>::clear(); psd.clear();}
@@ -255,14 +320,18 @@ public:
 		point const camera(get_camera_pos());
 		water_color_atten_at_pos(base_color, camera);
 
+		update_ctx_t ctx; // serial update, using rgen directly
+		ctx.rgen = rgen;
+
 		for (vector<vert_type_t>::iterator i = verts.begin(); i != verts.end(); ++i) {
-			check_pos(i->v, i->v);
+			check_pos(i->v, i->v, ctx);
 			if (animate2) {i->v += fticks*velocity[i - verts.begin()];}
 			colorRGBA color(base_color);
 			color.A -= cscale*p2p_dist(camera, i->v);
-			if (color.A <= 0.0) {i->v = gen_pt(i->v.z); continue;} // note: should be in check_pos()
+			if (color.A <= 0.0) {i->v = gen_pt(i->v.z, ctx.rgen); continue;} // note: should be in check_pos()
 			psd.add_pt(vert_color(i->v, color));
 		}
+		rgen = ctx.rgen;
 	}
 	void render() const { // partially transparent
 		if (empty()) return;
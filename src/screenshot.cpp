@@ -8,16 +8,152 @@
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iomanip>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "gl_includes.h"
 
 using namespace std;
 
+unsigned const CAPTURE_QUEUE_SIZE = 8; // max frames waiting for or being encoded
+unsigned const CAPTURE_NUM_PBOS   = 3; // frames of latency between glReadPixels() and reading the results, so that reads don't stall the GPU pipeline
+
+enum {CAPTURE_FMT_JPG=0, CAPTURE_FMT_BMP, CAPTURE_FMT_RAW, NUM_CAPTURE_FMTS};
+char const *capture_fmt_ext[NUM_CAPTURE_FMTS] = {"jpg", "bmp", "raw"};
+
+// config options
+unsigned video_capture_format(CAPTURE_FMT_JPG); // raw is the fastest to write but uses the most disk space
+bool video_capture_drop_frames(1); // if encoding falls behind: 1=drop new frames, 0=stall the frame until a buffer is free
+
 int write_jpeg_data(string const &fn, unsigned char const *const data, unsigned width, unsigned height, bool invert_y);
 bool write_rgb_bmp_image(string const &fn, unsigned char *data, unsigned width, unsigned height, unsigned ncolors);
+void bind_pbo(unsigned pbo_id);
 
 void print_text_onscreen_default(string const &text);
 
 
+struct capture_frame_t {
+	unsigned width=0, height=0, format=CAPTURE_FMT_JPG;
+	string fn;
+	vector<unsigned char> pixels; // RGB, bottom row first, as returned by glReadPixels()
+
+	bool write() { // called by encoder threads
+		switch (format) {
+		case CAPTURE_FMT_JPG: return write_jpeg_data(fn, pixels.data(), width, height, 1); // invert_y=1
+		case CAPTURE_FMT_BMP: return write_rgb_bmp_image(fn, pixels.data(), width, height, 3); // Note: modifies pixels (swaps R and B)
+		case CAPTURE_FMT_RAW: {
+			FILE *fp(fopen(fn.c_str(), "wb"));
+			if (fp == nullptr) {cerr << "Error opening raw image file " << fn << " for write." << endl; return 0;}
+			bool const ret(fwrite(pixels.data(), 1, 3*width*height, fp) == 3*width*height);
+			fclose(fp);
+			return ret;
+		}
+		default: assert(0);
+		}
+		return 0;
+	}
+};
+
+// Encodes and writes frames on background threads using a fixed pool of frame buffers.
+// Doesn't make any OpenGL calls, so it can be run headless by feeding it synthetic frames.
+class frame_encoder_t {
+	vector<capture_frame_t> frames; // buffer pool; never resized after start()
+	vector<unsigned> free_list;
+	queue<unsigned> pending;
+	vector<thread> threads;
+	mutex M;
+	condition_variable work_cv, free_cv;
+	unsigned num_busy=0, num_written=0, num_dropped=0;
+	bool kill_threads=0;
+
+	void encoder_loop() {
+		while (1) {
+			unsigned ix(0);
+			{
+				unique_lock<mutex> lock(M);
+				work_cv.wait(lock, [this]{return (kill_threads || !pending.empty());});
+				if (pending.empty()) return; // kill_threads is set; pending frames are always written first
+				ix = pending.front();
+				pending.pop();
+				++num_busy;
+			}
+			capture_frame_t &frame(frames[ix]);
+			if (!frame.write()) {cerr << "Error writing captured frame " << frame.fn << endl;}
+			{
+				lock_guard<mutex> lock(M);
+				free_list.push_back(ix);
+				--num_busy;
+				++num_written;
+			}
+			free_cv.notify_all();
+		} // end while()
+	}
+public:
+	~frame_encoder_t() {stop();}
+	bool is_running() const {return !threads.empty();}
+
+	void start(unsigned num_threads, unsigned queue_size) {
+		if (is_running()) return; // already started
+		assert(num_threads > 0 && queue_size > 0);
+		frames.resize(queue_size);
+		free_list.clear();
+		for (unsigned i = 0; i < queue_size; ++i) {free_list.push_back(i);}
+		kill_threads = 0;
+		for (unsigned i = 0; i < num_threads; ++i) {threads.emplace_back(&frame_encoder_t::encoder_loop, this);}
+	}
+	void stop() { // writes all pending frames, then joins the threads
+		if (!is_running()) return;
+		{
+			lock_guard<mutex> lock(M);
+			kill_threads = 1;
+		}
+		work_cv.notify_all();
+		for (thread &t : threads) {t.join();}
+		threads.clear();
+	}
+	// returns a free frame index, or -1 if none are free and block=0; the caller fills the frame and passes it to submit_frame()
+	int acquire_frame(bool block) {
+		assert(is_running());
+		unique_lock<mutex> lock(M);
+
+		if (free_list.empty()) {
+			if (!block) {++num_dropped; return -1;}
+			free_cv.wait(lock, [this]{return !free_list.empty();});
+		}
+		unsigned const ix(free_list.back());
+		free_list.pop_back();
+		return ix;
+	}
+	capture_frame_t &get_frame(unsigned ix) {assert(ix < frames.size()); return frames[ix];}
+
+	void submit_frame(unsigned ix) {
+		assert(ix < frames.size());
+		{
+			lock_guard<mutex> lock(M);
+			pending.push(ix);
+		}
+		work_cv.notify_one();
+	}
+	void wait_for_idle() {
+		unique_lock<mutex> lock(M);
+		free_cv.wait(lock, [this]{return (pending.empty() && num_busy == 0);});
+	}
+	unsigned get_num_written() const {return num_written;}
+	unsigned get_num_dropped() const {return num_dropped;}
+};
+
+frame_encoder_t frame_encoder;
+
+void start_frame_encoder() {
+	unsigned const num_hw_threads(thread::hardware_concurrency());
+	frame_encoder.start(max(1U, min(4U, num_hw_threads/2)), CAPTURE_QUEUE_SIZE); // leave most cores for the rest of 3DWorld
+}
+
+
 void read_depth_buffer(unsigned window_width, unsigned window_height, vector<float> &depth, bool normalize) {
 
 	depth.resize(window_width*window_height, 0.0);
@@ -55,9 +191,109 @@ int screenshot(unsigned window_width, unsigned window_height, char const *const
 	string const fn(oss.str());
 	cout << "Writing screenshot image " << fn << endl;
 	print_text_onscreen_default("Writing screenshot " + fn);
-	vector<unsigned char> buf((window_width+1)*(window_height+1)*3); // allocate extra size for alignment purposes - is this really needed?
-	read_pixels(window_width, window_height, buf);
-	if (write_bmp) {return write_rgb_bmp_image(fn, buf.data(), window_width, window_height, 3);} // BMP, RGB (ncolors=3) (40ms)
-	else           {return write_jpeg_data    (fn, buf.data(), window_width, window_height, 1);} // JPEG, invert_y=1 (110ms libjpeg, 226ms stb)
+	// the image is written on an encoder thread: BMP 40ms, JPEG 110ms libjpeg, 226ms stb
+	start_frame_encoder();
+	int const ix(frame_encoder.acquire_frame(1)); // block=1; never drop screenshots
+	capture_frame_t &frame(frame_encoder.get_frame(ix));
+	frame.width  = window_width;
+	frame.height = window_height;
+	frame.format = (write_bmp ? CAPTURE_FMT_BMP : CAPTURE_FMT_JPG);
+	frame.fn     = fn;
+	read_pixels(window_width, window_height, frame.pixels);
+	frame_encoder.submit_frame(ix);
+	return 1;
 }
 
+
+// Records every frame to a numbered image sequence. glReadPixels() writes into a ring of PBOs, and each PBO is read back
+// CAPTURE_NUM_PBOS-1 frames later when the GPU has finished with it, then handed off to the encoder threads.
+class video_recorder_t {
+	bool recording=0;
+	unsigned frame_id=0, pbo_ix=0, num_pbos_used=0, width=0, height=0, start_frame_id=0, start_dropped=0;
+	unsigned pbos[CAPTURE_NUM_PBOS] = {}, pbo_frame_ids[CAPTURE_NUM_PBOS] = {};
+
+	unsigned get_num_bytes() const {return 3*width*height;}
+
+	void read_back_oldest() {
+		assert(num_pbos_used > 0);
+		unsigned const ix((pbo_ix + CAPTURE_NUM_PBOS - num_pbos_used) % CAPTURE_NUM_PBOS);
+		--num_pbos_used;
+		int const fix(frame_encoder.acquire_frame(!video_capture_drop_frames));
+		if (fix < 0) return; // dropped
+		capture_frame_t &frame(frame_encoder.get_frame(fix));
+		ostringstream oss;
+		oss << "./frame" << setw(6) << setfill('0') << pbo_frame_ids[ix] << "." << capture_fmt_ext[video_capture_format];
+		frame.width  = width;
+		frame.height = height;
+		frame.format = video_capture_format;
+		frame.fn     = oss.str();
+		frame.pixels.resize(get_num_bytes());
+		bind_pbo(pbos[ix]);
+		void const *const ptr(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, get_num_bytes(), GL_MAP_READ_BIT));
+		assert(ptr != nullptr);
+		memcpy(frame.pixels.data(), ptr, get_num_bytes());
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		bind_pbo(0);
+		frame_encoder.submit_frame(fix);
+	}
+	void free_pbos() {
+		while (num_pbos_used > 0) {read_back_oldest();}
+		glDeleteBuffers(CAPTURE_NUM_PBOS, pbos);
+		for (unsigned i = 0; i < CAPTURE_NUM_PBOS; ++i) {pbos[i] = 0;}
+		pbo_ix = 0;
+	}
+	void alloc_pbos(unsigned window_width, unsigned window_height) {
+		width  = window_width;
+		height = window_height;
+		glGenBuffers(CAPTURE_NUM_PBOS, pbos);
+
+		for (unsigned i = 0; i < CAPTURE_NUM_PBOS; ++i) {
+			bind_pbo(pbos[i]);
+			glBufferData(GL_PIXEL_PACK_BUFFER, get_num_bytes(), NULL, GL_STREAM_READ);
+		}
+		bind_pbo(0);
+	}
+public:
+	bool is_recording() const {return recording;}
+
+	void start() {
+		if (recording) return;
+		if (video_capture_format >= NUM_CAPTURE_FMTS) {video_capture_format = CAPTURE_FMT_JPG;} // invalid config value
+		start_frame_encoder();
+		recording      = 1;
+		start_frame_id = frame_id; // frame numbers continue across recordings so that files aren't overwritten
+		start_dropped  = frame_encoder.get_num_dropped();
+		print_text_onscreen_default("Recording Frames");
+	}
+	void stop() {
+		if (!recording) return;
+		free_pbos();
+		recording = 0;
+		frame_encoder.wait_for_idle();
+		unsigned const num_dropped(frame_encoder.get_num_dropped() - start_dropped);
+		cout << "Recorded " << (frame_id - start_frame_id) << " frames, dropped " << num_dropped << endl;
+		print_text_onscreen_default("Recording Stopped");
+	}
+	void toggle() {if (recording) {stop();} else {start();}}
+
+	void capture_frame(unsigned window_width, unsigned window_height) { // called after the back buffer is swapped to the front
+		if (!recording) return;
+		if (pbos[0] && (window_width != width || window_height != height)) {free_pbos();} // window was resized
+		if (!pbos[0]) {alloc_pbos(window_width, window_height);}
+		if (num_pbos_used == CAPTURE_NUM_PBOS) {read_back_oldest();} // this PBO was written CAPTURE_NUM_PBOS-1 frames ago and should be ready
+		bind_pbo(pbos[pbo_ix]);
+		glReadBuffer(GL_FRONT);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, nullptr); // async; returns without waiting for the GPU
+		bind_pbo(0);
+		pbo_frame_ids[pbo_ix] = frame_id++;
+		pbo_ix = (pbo_ix + 1) % CAPTURE_NUM_PBOS;
+		++num_pbos_used;
+	}
+};
+
+video_recorder_t video_recorder;
+
+void toggle_video_recording() {video_recorder.toggle();}
+void maybe_capture_video_frame(unsigned window_width, unsigned window_height) {video_recorder.capture_frame(window_width, window_height);}
+
@@ -6,6 +6,7 @@
 #include "ship_util.h"
 #include "explosion.h"
 #include "obj_sort.h"
+#include "cobj_bsp_tree.h"
 
 
 bool const EXPLODE_LIGHTING = 1;
@@ -348,6 +349,44 @@ inline bool query_func_wrap(all_query_data &qdata, all_query query_func, unsigne
 }
 
 
+// sphere tree over a vector of cached objects, built once per frame when the ship vectors are rebuilt; used for closest ship queries on large vectors
+class cached_obj_tree_t : public cobj_tree_sphere_t {
+public:
+	void build(vector<cached_obj> const &objs) {
+		clear();
+		objects.reserve(objs.size());
+		for (unsigned i = 0; i < objs.size(); ++i) {objects.emplace_back(objs[i].pos, 0.0, i);} // zero radius, since queries use center distance
+		build_tree_top(0); // verbose=0
+	}
+};
+
+unsigned const MIN_QUERY_TREE_OBJS = 64; // use the x-sorted walk for smaller vectors
+cached_obj_tree_t ship_trees[NUM_ALIGNMENT], all_ships_tree, decoys_tree;
+
+
+void build_ship_query_trees() { // must be called after ships, all_ships, and decoys are updated
+
+	unsigned const num_trees(NUM_ALIGNMENT + 2);
+
+#pragma omp parallel for schedule(dynamic, 1)
+	for (int i = 0; i < (int)num_trees; ++i) {
+		cached_obj_tree_t &tree((i < NUM_ALIGNMENT) ? ship_trees[i] : ((i == NUM_ALIGNMENT) ? all_ships_tree : decoys_tree));
+		vector<cached_obj> const &objs((i < NUM_ALIGNMENT) ? ships[i] : ((i == NUM_ALIGNMENT) ? all_ships : decoys));
+		if (objs.size() >= MIN_QUERY_TREE_OBJS) {tree.build(objs);} else {tree.clear();}
+	}
+}
+
+
+cached_obj_tree_t const *get_query_tree(vector<cached_obj> const *objs) {
+
+	cached_obj_tree_t const *tree(nullptr);
+	if      (objs == &all_ships) {tree = &all_ships_tree;}
+	else if (objs == &decoys   ) {tree = &decoys_tree;}
+	else if (objs >= ships && objs < ships+NUM_ALIGNMENT) {tree = &ship_trees[objs - ships];}
+	return ((tree == nullptr || tree->is_empty()) ? nullptr : tree);
+}
+
+
 template<typename data_t, typename query> void find_close_objects(data_t &qdata, query query_func, unsigned bad_flags=0) {
 
 	assert(qdata.objs != NULL);
@@ -365,6 +404,23 @@ template<typename data_t, typename query> void find_close_objects(data_t &qdata,
 }
 
 
+void find_closest_object(closeness_data &qdata) { // same result as find_close_objects(qdata, update_min_d), but uses the query tree if available
+
+	cached_obj_tree_t const *const tree(get_query_tree(qdata.objs));
+	if (tree == nullptr) {find_close_objects(qdata, update_min_d); return;}
+	static vector<unsigned> cands; // not thread safe
+	cands.clear();
+	tree->get_ids_int_sphere(qdata.pos, qdata.dmin, cands); // objects within the initial search distance
+	sort(cands.begin(), cands.end());
+	unsigned const start(binary_search_pos(*(qdata.objs), qdata.pos));
+	auto const split(upper_bound(cands.begin(), cands.end(), start));
+	// visit candidates in the same order as the x-sorted walk (left then right) so that pruning and ties resolve the same way;
+	// objects skipped by the walk's early exit are farther than dmin, so they're rejected here anyway
+	for (auto i = split; i != cands.begin() && !qdata.exit_query;) {update_min_d(qdata, *(--i));}
+	for (auto i = split; i != cands.end()   && !qdata.exit_query; ++i) {update_min_d(qdata, *i);}
+}
+
+
 // ************************** QUERY DRIVERS ****************************
 
 
@@ -440,12 +496,12 @@ free_obj *free_obj::get_closest_ship(point const &pos, float min_dist, float max
 
 	if (decoy_tricked && !decoys.empty()) {
 		cdata.objs = &decoys;
-		find_close_objects(cdata, update_min_d);
+		find_closest_object(cdata);
 	}
 	if (attack_all) {
 		assert(enemy);
 		cdata.objs = &all_ships;
-		find_close_objects(cdata, update_min_d);
+		find_closest_object(cdata);
 	}
 	else {
 		unsigned const alignment(get_align());
@@ -475,7 +531,7 @@ free_obj *free_obj::get_closest_ship(point const &pos, float min_dist, float max
 		for (unsigned i = 0; i < NUM_ALIGNMENT; ++i) {
 			if (!testset[i]) continue;
 			cdata.objs = &ships[i];
-			find_close_objects(cdata, update_min_d);
+			find_closest_object(cdata);
 		}
 	}
 	return cdata.closest;
@@ -485,7 +541,7 @@ free_obj *free_obj::get_closest_ship(point const &pos, float min_dist, float max
 free_obj *u_ship::get_closest_dock(float max_dist) const {
 
 	closeness_data cdata(&ships[alignment], pos, max_dist, radius*radius, this, 0, 1, 1);
-	find_close_objects(cdata, update_min_d);
+	find_closest_object(cdata);
 	return cdata.closest;
 }
 
@@ -236,6 +236,7 @@ free_obj *line_intersect_free_objects(line_int_data &li_data, int obj_types, uns
 uobject *line_intersect_objects(line_int_data &li_data, free_obj *&fobj, int obj_types);
 unsigned check_for_obj_coll(point const &pos, float radius);
 void get_all_close_objects(all_query_data &qdata);
+void build_ship_query_trees();
 void register_attack_from(free_obj const *attacker, unsigned target_align);
 void register_damage(int t_sclass, int s_sclass, int wclass, float damage, unsigned s_align, unsigned t_align, bool is_kill, bool is_self=0);
 void change_speed_mode(int val);
@@ -11,43 +11,96 @@
 #include "stb_dxt.h"
 bool const USE_STB_DXT = 1;
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define USE_SSE2_MIPMAPS
+#endif
+
 using namespace std;
 
+bool fast_texture_compress(0); // config option: single refinement step rather than two; ~30% faster compression with slightly lower quality
+
 bool gen_mipmaps(unsigned dim=2);
 string prepend_texture_dir(string const &filename);
 
 
+struct mipmap_level_t {
+	unsigned w=0, h=0;
+	vector<uint8_t> data, comp_data; // data is empty for level 0, which uses the texture's own data
+};
+
+unsigned get_comp_block_size(int ncolors) {return ((ncolors == 3) ? 8 : 16);} // BC1 is 8 bytes per 4x4 block; BC3 and BC5 are 16 bytes
+unsigned get_comp_data_size (int width, int height, int ncolors) {return ((width + 3)/4)*((height + 3)/4)*get_comp_block_size(ncolors);} // take ceil()
+
+// compresses one row of 4x4 blocks starting at texel row y; comp_data points to the start of the compressed image
+void dxt_compress_block_row(uint8_t const *const data, uint8_t *const comp_data, int width, int height, int ncolors, int y) {
+	// see https://www.reedbeta.com/blog/understanding-bcn-texture-compression-formats/
+	// RG=BC5, RGB=DXT1/BC1, RGBA=DXT5/BC3
+	bool const has_alpha(ncolors == 4), is_rg(ncolors == 2);
+	unsigned const block_sz(get_comp_block_size(ncolors)), x_blocks((width + 3)/4), out_ncolors(is_rg ? 2 : 4);
+	int const mode(fast_texture_compress ? STB_DXT_NORMAL : STB_DXT_HIGHQUAL);
+	uint8_t block[4*4*4] = {};
+
+	for (int x = 0; x < width; x += 4) {
+		for (int yy = 0; yy < 4; ++yy) {
+			for (int xx = 0; xx < 4; ++xx) {
+				unsigned const bix(out_ncolors*(4*yy + xx));
+				// clamp to valid input texture range in case width and height are not a multiple of 4, which duplicates rows and columns
+				unsigned const dix(ncolors*(width*min(y+yy, height-1) + min(x+xx, width-1)));
+				for (int c = 0; c < ncolors; ++c) {block[bix + c] = data[dix + c];}
+				if (ncolors == 3) {block[bix + 3] = 255;} // set alpha=255
+			}
+		}
+		uint8_t *const dest(comp_data + ((y/4)*x_blocks + (x/4))*block_sz);
+		if (is_rg) {stb_compress_bc5_block(dest, block);}
+		else {stb_compress_dxt_block(dest, block, has_alpha, mode);}
+	} // for x
+}
+
 void dxt_texture_compress(uint8_t const *const data, vector<uint8_t> &comp_data, int width, int height, int ncolors) {
 	//highres_timer_t timer("stb_dxt Texture Compress", 1, 1); // enabled, no loading screen
 	assert(width > 0 && height > 0);
-	assert(ncolors == 3 || ncolors == 4);
+	assert(ncolors >= 2 && ncolors <= 4);
 	assert(data != nullptr);
-	// see https://www.reedbeta.com/blog/understanding-bcn-texture-compression-formats/
-	// RGB=DXT1/BC1, RGBA=DXT5/BC3
-	// normal maps could use BC5 with stb_compress_bc5_block() if they were changed to two components and z is calculated in the shader
-	bool const has_alpha(ncolors == 4);
-	unsigned const block_sz(has_alpha ? 16 : 8), x_blocks((width + 3)/4), y_blocks((height + 3)/4); // take ceil()
-	comp_data.resize(x_blocks*y_blocks*block_sz);
+	// normal maps could use BC5 (ncolors=2) if they were changed to two components and z is calculated in the shader
+	comp_data.resize(get_comp_data_size(width, height, ncolors));
 
 #pragma omp parallel for schedule(static)
-	for (int y = 0; y < height; y += 4) {
-		uint8_t block[4*4*4] = {};
-
-		for (int x = 0; x < width; x += 4) {
-			for (int yy = 0; yy < 4; ++yy) {
-				for (int xx = 0; xx < 4; ++xx) {
-					unsigned const bix(4*(4*yy + xx));
-					// clamp to valid input texture range in case width and height are not a multiple of 4, which duplicates rows and columns
-					unsigned const dix(ncolors*(width*min(y+yy, height-1) + min(x+xx, width-1)));
-					for (int c = 0; c < ncolors; ++c) {block[bix + c] = data[dix + c];}
-					if (!has_alpha) {block[bix + 3] = 255;} // set alpha=255
-				}
-			}
-			unsigned const comp_offset(((y/4)*x_blocks + (x/4))*block_sz);
-			assert(comp_offset < comp_data.size());
-			stb_compress_dxt_block(&comp_data[comp_offset], block, has_alpha, /*STB_DXT_NORMAL*/STB_DXT_HIGHQUAL);
-		} // for x
-	} // for y
+	for (int y = 0; y < height; y += 4) {dxt_compress_block_row(data, comp_data.data(), width, height, ncolors, y);}
+}
+
+// compresses all mipmap levels, including the base level, in a single parallel loop so that small levels don't each pay the cost of a parallel region
+void dxt_compress_mipmap_chain(uint8_t const *const data, vector<mipmap_level_t> &levels, int ncolors) {
+	//highres_timer_t timer("stb_dxt Mipmap Chain Compress", 1, 1); // enabled, no loading screen
+	assert(!levels.empty());
+	vector<pair<unsigned, unsigned>> work_items; // {level, y}
+
+	for (unsigned n = 0; n < levels.size(); ++n) {
+		mipmap_level_t &level(levels[n]);
+		level.comp_data.resize(get_comp_data_size(level.w, level.h, ncolors));
+		for (unsigned y = 0; y < level.h; y += 4) {work_items.emplace_back(n, y);}
+	}
+#pragma omp parallel for schedule(dynamic, 4)
+	for (int i = 0; i < (int)work_items.size(); ++i) {
+		mipmap_level_t &level(levels[work_items[i].first]);
+		uint8_t const *const idata((work_items[i].first == 0) ? data : level.data.data());
+		dxt_compress_block_row(idata, level.comp_data.data(), level.w, level.h, ncolors, work_items[i].second);
+	}
+}
+
+// sums two rows of bytes into 16-bit values; this is the vertical half of the separable 2x2 box filter
+void sum_rows_u16(uint8_t const *const r0, uint8_t const *const r1, uint16_t *const sum, unsigned len) {
+	unsigned i(0);
+#ifdef USE_SSE2_MIPMAPS
+	__m128i const zero(_mm_setzero_si128());
+
+	for (; i+16 <= len; i += 16) {
+		__m128i const a(_mm_loadu_si128((__m128i const *)(r0 + i))), b(_mm_loadu_si128((__m128i const *)(r1 + i)));
+		_mm_storeu_si128((__m128i *)(sum + i    ), _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero)));
+		_mm_storeu_si128((__m128i *)(sum + i + 8), _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero)));
+	}
+#endif
+	for (; i < len; ++i) {sum[i] = uint16_t(r0[i]) + r1[i];} // remainder
 }
 
 void create_one_mipmap(uint8_t const *const idata, vector<uint8_t> &odata, unsigned w1, unsigned h1, unsigned w2, unsigned h2,
@@ -96,58 +149,84 @@ void create_one_mipmap(uint8_t const *const idata, vector<uint8_t> &odata, unsig
 			} // for x
 		} // for y
 	}
-	else { // simple 2x2 box filter path
-#pragma omp parallel for schedule(static)
-		for (int y = 0; y < (int)h2; ++y) { // simple 2x2 box filter
-			for (int x = 0; x < (int)w2; ++x) {
-				unsigned const ix1(ncolors*(y*w2+x)), ix2(ncolors*((y<<1)*w1+(x<<1)));
+	else { // simple 2x2 box filter path, split into a SIMD vertical pass and a scalar horizontal pass
+		unsigned const row_len(ncolors*w1);
+
+#pragma omp parallel
+		{
+			vector<uint16_t> row_sum(row_len); // per-thread
+
+#pragma omp for schedule(static)
+			for (int y = 0; y < (int)h2; ++y) {
+				uint8_t const *const row(idata + (y<<1)*row_len);
+				uint8_t *const out(odata.data() + ncolors*y*w2);
+				sum_rows_u16(row, row+yinc, row_sum.data(), row_len);
 
-				for (int n = 0; n < ncolors; ++n) {
-					odata[ix1+n] = uint8_t(((unsigned)idata[ix2+n] + idata[ix2+xinc+n] + idata[ix2+yinc+n] + idata[ix2+yinc+xinc+n]) >> 2);
+				for (unsigned x = 0; x < w2; ++x) {
+					unsigned const ix1(ncolors*x), ix2(ncolors*(x<<1));
+					for (int n = 0; n < ncolors; ++n) {out[ix1+n] = uint8_t(((unsigned)row_sum[ix2+n] + row_sum[ix2+xinc+n]) >> 2);}
 				}
-			}
-		} // for y
+			} // for y
+		} // end omp parallel
+	}
+}
+
+// creates levels 1+ of the mipmap chain; levels[0] is the base texture with empty data
+void create_mipmap_chain(uint8_t const *const data, vector<mipmap_level_t> &levels, unsigned width, unsigned height,
+	int ncolors, unsigned use_mipmaps, colorRGBA const &color, float mipmap_alpha_weight)
+{
+	levels.clear();
+	levels.push_back(mipmap_level_t());
+	levels.back().w = width;
+	levels.back().h = height;
+
+	for (unsigned w = width, h = height; w > 1 || h > 1; w >>= 1, h >>= 1) {
+		unsigned const w1(max(w, 1U)), h1(max(h, 1U)), w2(max(w>>1, 1U)), h2(max(h>>1, 1U));
+		mipmap_level_t level;
+		level.w = w2;
+		level.h = h2;
+		uint8_t const *const idata((levels.size() == 1) ? data : levels.back().data.data());
+		create_one_mipmap(idata, level.data, w1, h1, w2, h2, ncolors, use_mipmaps, color, mipmap_alpha_weight);
+		levels.push_back(move(level));
 	}
 }
 
 void texture_t::compress_and_send_texture_with_mipmaps() {
 	assert(is_allocated());
 	assert(width > 0 && height > 0);
-	bool const compressed(is_texture_compressed()), use_custom_compress(USE_STB_DXT && compressed && (ncolors == 3 || ncolors == 4));
+	bool const compressed(is_texture_compressed()), use_custom_compress(USE_STB_DXT && compressed && (ncolors >= 2 && ncolors <= 4));
 	bool const use_normal_mipmaps(use_mipmaps == 1 || use_mipmaps == 2), use_custom_mipmaps(use_mipmaps == 3 || use_mipmaps == 4);
 	GLenum const format(calc_internal_format());
-	vector<uint8_t> comp_data, idatav, odata; // reused across calls; doesn't seem to help much
+	vector<mipmap_level_t> levels;
 
 	if ((use_custom_compress && use_normal_mipmaps) || use_custom_mipmaps) { // mipmap creation for compressed and non-compressed textures
 		//highres_timer_t timer("create_mipmaps", 1, 1); // enabled, no loading screen; 1500ms total for city + cars + people
-
-		for (unsigned w = width, h = height, level = 1; w > 1 || h > 1; w >>= 1, h >>= 1, ++level) {
-			unsigned const w1(max(w, 1U)), h1(max(h, 1U)), w2(max(w>>1, 1U)), h2(max(h>>1, 1U));
-			uint8_t const *const idata((level == 1) ? data : idatav.data());
-			create_one_mipmap(idata, odata, w1, h1, w2, h2, ncolors, use_mipmaps, color, mipmap_alpha_weight);
-
-			if (compressed) { // uses stb
-				dxt_texture_compress(odata.data(), comp_data, w2, h2, ncolors);
-				GL_CHECK(glCompressedTexImage2D(GL_TEXTURE_2D, level, format, w2, h2, 0, comp_data.size(), comp_data.data());)
-			}
-			else { // 10ms
-				glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // needed for mipmap levels where width*ncolors is not aligned
-				glTexImage2D(GL_TEXTURE_2D, level, format, w2, h2, 0, calc_format(), get_data_format(), odata.data());
-				glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-			}
-			idatav.swap(odata);
-		} // for level
+		create_mipmap_chain(data, levels, width, height, ncolors, use_mipmaps, color, mipmap_alpha_weight);
 	}
-	if (use_custom_compress) { // compressed RGB or RGBA + mipmaps
+	if (use_custom_compress) { // compressed RG, RGB, or RGBA + mipmaps
 		//highres_timer_t timer("compress_and_send_texture", 1, 1); // enabled, no loading screen; 500ms; less with PBO (but total load time is not actually faster)
-		// sending the main texture last seems to be slightly faster because it will block on the first mipmap if sent first; if sent last it may overlap with compress
-		dxt_texture_compress(data, comp_data, width, height, ncolors); // 640ms
-		GL_CHECK(glCompressedTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, comp_data.size(), comp_data.data());); // 36ms
+		if (levels.empty()) { // no mipmaps; compress only the base level
+			levels.push_back(mipmap_level_t());
+			levels.back().w = width;
+			levels.back().h = height;
+		}
+		dxt_compress_mipmap_chain(data, levels, ncolors); // uses stb; 640ms for the base level alone when done serially
+
+		for (unsigned n = 0; n < levels.size(); ++n) {
+			mipmap_level_t const &level(levels[n]);
+			GL_CHECK(glCompressedTexImage2D(GL_TEXTURE_2D, n, format, level.w, level.h, 0, level.comp_data.size(), level.comp_data.data());) // 36ms for level 0
+		}
+		return;
 	}
-	else { // font atlas and noise gen texture
-		glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, calc_format(), get_data_format(), data); // 44ms
-		if (use_normal_mipmaps) {gen_mipmaps();} // Note: compressed mipmaps are created inside compress_and_send_texture()
+	// font atlas and noise gen texture
+	glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, calc_format(), get_data_format(), data); // 44ms
+
+	if (!levels.empty()) { // custom mipmaps; 10ms
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // needed for mipmap levels where width*ncolors is not aligned
+		for (unsigned n = 1; n < levels.size(); ++n) {glTexImage2D(GL_TEXTURE_2D, n, format, levels[n].w, levels[n].h, 0, calc_format(), get_data_format(), levels[n].data.data());}
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 	}
+	else if (use_normal_mipmaps) {gen_mipmaps();} // Note: compressed mipmaps are created above
 }
 
 // these functions read and write the native "tex2d" binary file format, which contains compressed texture data with mipmaps
@@ -179,7 +258,7 @@ void texture_t::write_texture2d_binary(string const &fn) const {
 	assert(USE_STB_DXT);
 	assert(is_texture_compressed()); // only compressed formats are supported
 	assert(!is_16_bit_gray);
-	assert(ncolors == 3 || ncolors == 4);
+	assert(ncolors >= 2 && ncolors <= 4);
 	write_uint(out, TEX3D_MAGIC_NUMBER);
 	// write texture metadata
 	write_val(out, width);
@@ -187,22 +266,19 @@ void texture_t::write_texture2d_binary(string const &fn) const {
 	write_val(out, ncolors);
 	write_val(out, color);
 	write_val(out, use_mipmaps);
-	// write compressed RGB or RGBA + mipmaps
-	vector<uint8_t> comp_data, idatav, odata; // reused across calls
-	dxt_texture_compress(data, comp_data, width, height, ncolors); // uses stb
-	write_vector(out, comp_data);
+	// write compressed RG, RGB, or RGBA + mipmaps
+	vector<mipmap_level_t> levels;
+	if (use_mipmaps) {create_mipmap_chain(data, levels, width, height, ncolors, use_mipmaps, color, mipmap_alpha_weight);}
+	else {levels.resize(1); levels[0].w = width; levels[0].h = height;}
+	dxt_compress_mipmap_chain(data, levels, ncolors); // uses stb
+	write_vector(out, levels[0].comp_data);
 
 	if (use_mipmaps) { // write mipmaps
-		for (unsigned w = width, h = height, level = 1; w > 1 || h > 1; w >>= 1, h >>= 1, ++level) {
-			unsigned const w1(max(w, 1U)), h1(max(h, 1U)), w2(max(w>>1, 1U)), h2(max(h>>1, 1U));
-			uint8_t const *const idata((level == 1) ? data : idatav.data());
-			create_one_mipmap(idata, odata, w1, h1, w2, h2, ncolors, use_mipmaps, color, mipmap_alpha_weight);
-			dxt_texture_compress(odata.data(), comp_data, w2, h2, ncolors); // uses stb
-			write_val(out, w2);
-			write_val(out, h2);
-			write_vector(out, comp_data);
-			idatav.swap(odata);
-		} // for level
+		for (unsigned n = 1; n < levels.size(); ++n) {
+			write_val(out, levels[n].w);
+			write_val(out, levels[n].h);
+			write_vector(out, levels[n].comp_data);
+		}
 		unsigned terminator(0);
 		write_val(out, terminator);
 	}
@@ -236,8 +312,8 @@ void texture_t::read_texture2d_binary() {
 	read_val(in, color);
 	read_val(in, use_mipmaps);
 	assert(width > 0 && height > 0);
-	assert(ncolors == 3 || ncolors == 4);
-	// read compressed RGB or RGBA + mipmaps
+	assert(ncolors >= 2 && ncolors <= 4);
+	// read compressed RG, RGB, or RGBA + mipmaps
 	vector<uint8_t> comp_data;
 	read_vector(in, comp_data);
 	assert(!comp_data.empty());
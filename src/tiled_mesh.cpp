@@ -32,6 +32,8 @@ float const SMAP_DEL_THRESH   = 1.3;
 float const SMAP_FADE_THRESH  = 1.5;
 float const OCCLUDER_DIST     = 0.2;
 float const FLOWER_REL_DIST   = 0.9; // flower view distance relative to grass view distance
+float const TILE_GEN_LOOKAHEAD = 30.0; // in frames; camera velocity prediction for tile generation priority
+float const TILE_GEN_VIEW_WT   = 0.5; // distance multiplier for tiles behind the view direction
 
 int   const LIGHTNING_LIGHT = 2;
 float const LIGHTNING_FREQ  = 200.0; // in ticks (1/40 s)
@@ -313,8 +315,12 @@ tile_t::tile_t(unsigned size_, int x, int y) : size(size_), stride(size+1), zvsi
 	base_tsize = NORM_TEXELS;
 }
 
-float tile_t::get_draw_priority() const {
-	return (p2p_dist_xy(get_camera_pos(), get_center()) + (is_visible() ? 0.0 : FAR_CLIP)); // prioritize visible tiles
+float tile_t::get_gen_priority(point const &gen_pos) const { // lower value = generated first; gen_pos is the predicted camera pos
+	vector3d tdir(get_center() - gen_pos), vdir(camera_pdu.dir);
+	tdir.z = vdir.z = 0.0; // XY only
+	float const denom(tdir.mag()*vdir.mag()), view_dp((denom > 0.0) ? dot_product(tdir, vdir)/denom : 1.0);
+	float const view_scale(1.0 + TILE_GEN_VIEW_WT*(1.0 - view_dp)); // prefer tiles in front of the camera
+	return (view_scale*p2p_dist_xy(gen_pos, get_center()) + (is_visible() ? 0.0 : FAR_CLIP)); // prioritize visible tiles
 }
 
 
@@ -1663,12 +1669,18 @@ unsigned tile_t::draw_grass(shader_t &s, vector<vector<vector2d> > *insts, bool
 	return num_drawn;
 }
 
-unsigned tile_t::draw_flowers(shader_t &s, bool use_cloud_shadows) {
+bool tile_t::gen_flowers_if_close() { // no GL calls, can be called in parallel across tiles
 
 	if (!has_grass()) return 0; // no grass, no flowers
 	float const flower_thresh(FLOWER_REL_DIST*get_grass_thresh_pad());
 	if (get_min_dist_to_pt(get_camera_pos()) > flower_thresh) return 0; // too far away to draw
 	flowers.gen_flowers(weight_data, weights_tsize, x1-xoff2, y1-yoff2, tsize_bitshift); // mesh weight + tree dirt
+	return 1;
+}
+
+unsigned tile_t::draw_flowers(shader_t &s, bool use_cloud_shadows) {
+
+	if (!gen_flowers_if_close()) return 0; // usually already generated
 	if (flowers.empty()) return 0; // no flowers generated
 	pre_draw_grass_flowers(s, use_cloud_shadows);
 	flowers.check_vbo();
@@ -2314,7 +2326,8 @@ float tile_draw_t::update(float &min_camera_dist) { // view-independent updates;
 	unsigned const max_tile_gen_per_frame = 16; // higher = less overall gen time (more parallel), but longer wait for first render
 	unsigned const max_cpu_tiles          = 3; // 0 = GPU only
 	unsigned const max_defer_tiles        = 8; // 0 = disable
-	if (height_gens.empty()) {height_gens.resize(max(max_defer_tiles, 1U));}
+	unsigned const min_parallel_tiles     = 4; // generate whole tiles in parallel on the CPU when at least this many are scheduled
+	if (height_gens.empty()) {height_gens.resize(max(max(max_defer_tiles, max_tile_gen_per_frame), 1U));} // one per tile for async or parallel generation
 
 	if (terrain_hmap_manager.maybe_load(mh_filename_tt, (invert_mh_image != 0))) {
 		read_default_hmap_modmap();
@@ -2344,6 +2357,14 @@ float tile_draw_t::update(float &min_camera_dist) { // view-independent updates;
 	bool const create_buildings_first(FLATTEN_BUILDING_TILE && using_tiled_terrain_hmap_tex());
 	unsigned num_erased(0);
 	min_camera_dist = FAR_DISTANCE;
+	// track smoothed camera velocity so that tiles in the direction of motion are generated first; ignore teleports and mesh shifts
+	vector3d const camera_delta(cpos - last_camera_pos);
+	if (last_camera_pos != all_zeros && camera_delta.mag() < X_SCENE_SIZE) {camera_vel = 0.8*camera_vel + 0.2*camera_delta;} else {camera_vel = zero_vector;}
+	last_camera_pos = cpos;
+	vector3d gen_offset(TILE_GEN_LOOKAHEAD*camera_vel);
+	gen_offset.z = 0.0;
+	if (gen_offset.mag() > 2.0*X_SCENE_SIZE) {gen_offset *= 2.0*X_SCENE_SIZE/gen_offset.mag();} // limit to about one tile ahead
+	point const gen_pos(cpos + gen_offset);
 	// Note: we may want to calculate distant low-res or larger tiles when the camera is high above the mesh
 
 	if (!to_gen_zvals.empty()) {
@@ -2371,7 +2392,7 @@ float tile_draw_t::update(float &min_camera_dist) { // view-independent updates;
 			tile_t tile(get_tile_size(), x, y);
 			if (!tile.rel_dist_to_camera_xy_lt(CREATE_DIST_TILES)) continue; // too far away to create
 			tile_t *new_tile(new tile_t(tile));
-			to_gen_zvals.emplace_back(new_tile->get_draw_priority(), new_tile);
+			to_gen_zvals.emplace_back(new_tile->get_gen_priority(gen_pos), new_tile);
 			// in this mode, we need to place buildings and flatten the heightmap before calculating tile heights
 			if (create_buildings_first) {create_buildings_tile(x, y, 1);}
 		} // for x
@@ -2406,12 +2427,17 @@ float tile_draw_t::update(float &min_camera_dist) { // view-independent updates;
 		if (gpu_mode && gen_this_frame <= max_cpu_tiles) {mesh_gen_mode = MGEN_SIMPLEX;} // GPU simplex => CPU simplex
 		if (gen_this_frame < num_to_gen) {sort(to_gen_zvals.begin(), to_gen_zvals.end());} // sort by priority if not all generated
 
-		for (unsigned i = 0; i < num_to_gen; ++i) {
-			tile_t *tile(to_gen_zvals[i].second);
-			if (i >= gen_this_frame) {delete tile; continue;} // delete these tiles - they will be created in a later frame
-			tile->create_zvals(height_gens[0], 0); // generate these tiles
-			insert_tile(tile);
+		for (unsigned i = gen_this_frame; i < num_to_gen; ++i) {delete to_gen_zvals[i].second;} // delete these tiles - they will be created in a later frame
+
+		if (mesh_gen_mode < MGEN_SIMPLEX_GPU && gen_this_frame >= min_parallel_tiles) { // CPU mode: generate whole tiles in parallel, each with its own height gen
+			assert(gen_this_frame <= height_gens.size());
+#pragma omp parallel for schedule(dynamic,1)
+			for (int i = 0; i < (int)gen_this_frame; ++i) {to_gen_zvals[i].second->create_zvals(height_gens[i], 0);}
 		}
+		else { // GPU compute must be run serially on the main thread; CPU mode with too few tiles is also serial, with parallelism within each tile
+			for (unsigned i = 0; i < gen_this_frame; ++i) {to_gen_zvals[i].second->create_zvals(height_gens[0], 0);}
+		}
+		for (unsigned i = 0; i < gen_this_frame; ++i) {insert_tile(to_gen_zvals[i].second);} // insert in priority order
 		to_gen_zvals.clear();
 		mesh_gen_mode = prev_mesh_gen_mode;
 	}
@@ -3431,6 +3457,10 @@ void tile_draw_t::draw_grass(bool reflection_pass) {
 	} // for wpass
 
 	// draw flowers
+	if (flower_density > 0.0) { // generate flowers for newly visible tiles in parallel
+#pragma omp parallel for schedule(dynamic,1)
+		for (int i = 0; i < (int)to_draw.size(); ++i) {to_draw[i].second->gen_flowers_if_close();}
+	}
 	for (unsigned spass = 0; spass < 2; ++spass) { // shadow maps, no shadow maps
 		if (flower_density == 0.0) continue; // no flowers
 		if (spass == 0 && !shadow_map_enabled()) continue;
@@ -336,7 +336,7 @@ public:
 	float get_tree_far_weight(bool force_high_detail, bool has_palm=0) const {
 		return ((ENABLE_TREE_LOD && !force_high_detail) ? CLIP_TO_01(GEOMORPH_THRESH*(get_tree_dist_scale(has_palm) - 1.0f)) : 0.0);
 	}
-	float get_draw_priority() const;
+	float get_gen_priority(point const &gen_pos) const;
 
 	// *** trees ***
 	template <typename T> void postproc_trees(T const &trees, float &tzmax) { // pine/decidious trees
@@ -367,6 +367,7 @@ public:
 	void draw_scenery(shader_t &s, shader_t &vrs, bool draw_opaque, bool draw_leaves, bool reflection_pass, bool shadow_pass=0, bool enable_shadow_maps=0);
 	void pre_draw_grass_flowers(shader_t &s, bool use_cloud_shadows) const;
 	unsigned draw_grass(shader_t &s, vector<vector<vector2d> > *insts, bool use_cloud_shadows, bool enable_tess, int lt_loc);
+	bool gen_flowers_if_close();
 	unsigned draw_flowers(shader_t &s, bool use_cloud_shadows);
 	bool choose_butterfly_dest(point &dest, sphere_t &plant_bsphere, rand_gen_t &rgen) const;
 
@@ -412,6 +413,8 @@ class tile_draw_t : public indexed_vbo_manager_t {
 	unsigned ivbo_ixs[NUM_LODS+1] = {};
 	unsigned tiles_gen_prev_frame=0;
 	float terrain_zmin=0.0;
+	point last_camera_pos;
+	vector3d camera_vel; // smoothed per-frame camera motion, for tile generation priority
 	draw_vect_t to_draw, to_gen_zvals;
 	vector<tile_t *> occluded_tiles, to_draw_trunk_pts;
 	cloud_draw_list_t to_draw_clouds;
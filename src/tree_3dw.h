@@ -111,9 +111,9 @@ struct tree_xform_t {
 
 class tree_builder_t : public tree_xform_t {
 
-	static vector<tree_cylin >   cylin_cache;
-	static vector<tree_branch>   branch_cache;
-	static vector<tree_branch *> branch_ptr_cache;
+	static thread_local vector<tree_cylin >   cylin_cache; // thread_local so that trees can be generated in parallel
+	static thread_local vector<tree_branch>   branch_cache;
+	static thread_local vector<tree_branch *> branch_ptr_cache;
 	tree_branch base, roots, *branches_34[2]={}, **branches=nullptr;
 	int base_num_cylins=0, root_num_cylins=0, ncib=0, num_1_branches=0, num_big_branches_min=0, num_big_branches_max=0;
 	int num_2_branches_min=0, num_2_branches_max=0, num_34_branches[2]={}, num_3_branches_min=0, num_3_branches_max=0;
@@ -338,6 +338,7 @@ class tree_data_manager_t : public vector<tree_data_t> {
 	int last_rgi=0;
 public:
 	void ensure_init();
+	void gen_missing(bool allow_bushes);
 	void clear_context();
 	void on_leaf_color_change();
 	size_t get_gpu_mem() const;
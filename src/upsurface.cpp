@@ -13,6 +13,54 @@ float const F_ATTEN_FACTOR = 0.4;
 extern int display_mode;
 
 
+class surface_hmap_cache_t { // caches generated planet/moon heightmaps so that revisited bodies don't need to recompute their sine sums
+	struct key_t {
+		int rs1, rs2;
+		unsigned size;
+		key_t(rand_gen_t const &rgen, unsigned size_) : rs1(rgen.rseed1), rs2(rgen.rseed2), size(size_) {}
+		bool operator<(key_t const &k) const {
+			if (rs1 != k.rs1) return (rs1 < k.rs1);
+			if (rs2 != k.rs2) return (rs2 < k.rs2);
+			return (size < k.size);
+		}
+	};
+	struct entry_t {
+		vector<float> hmap;
+		unsigned last_used=0;
+	};
+	map<key_t, entry_t> entries;
+	unsigned cur_time=0;
+	size_t mem_used=0; // in floats
+
+	void free_lru_entry() {
+		assert(!entries.empty());
+		auto lru(entries.begin());
+		for (auto i = entries.begin(); i != entries.end(); ++i) {if (i->second.last_used < lru->second.last_used) {lru = i;}}
+		mem_used -= lru->second.hmap.size();
+		entries.erase(lru);
+	}
+public:
+	bool lookup(rand_gen_t const &rgen, unsigned size, vector<float> &hmap) {
+		auto it(entries.find(key_t(rgen, size)));
+		if (it == entries.end()) return 0;
+		assert(it->second.hmap.size() == hmap.size());
+		copy(it->second.hmap.begin(), it->second.hmap.end(), hmap.begin());
+		it->second.last_used = ++cur_time;
+		return 1;
+	}
+	void add(rand_gen_t const &rgen, unsigned size, vector<float> const &hmap) {
+		size_t const max_mem(64*MAX_TEXTURE_SIZE*MAX_TEXTURE_SIZE); // 64 full size heightmaps = 16MB
+		entry_t &e(entries[key_t(rgen, size)]);
+		mem_used  += hmap.size() - e.hmap.size();
+		e.hmap     = hmap;
+		e.last_used= ++cur_time;
+		while (mem_used > max_mem && entries.size() > 1) {free_lru_entry();}
+	}
+};
+
+surface_hmap_cache_t surface_hmap_cache;
+
+
 void noise_gen_3d::gen_sines(float mag, float freq) {
 
 	assert(SINES_PER_FREQ >= 2);
@@ -196,63 +244,74 @@ void urev_body::gen_texture_data_and_heightmap(unsigned char *data, unsigned siz
 	for (unsigned sz = size; sz > 1; sz >>= 1, ++size_p2);
 	assert((1U<<size_p2) == size); // size must be a power of 2
 	assert(surface != nullptr);
-	unsigned const table_size(MAX_TEXTURE_SIZE << 1); // larger is more accurate
-	static float xtable[TOT_NUM_SINES*table_size] = {}, ytable[TOT_NUM_SINES*table_size] = {};
 	surface->setup(size, max(water, lava), 1); // use_heightmap=1
-	unsigned const num_sines(surface->num_sines);
-	float const *const rdata(surface->rdata);
-	float const mt2(0.5*(table_size-1)), scale(1.5/surface->max_mag);
-	float const delta(TWO_PI/size), sin_ds(sin(delta)), cos_ds(cos(delta));
-	unsigned const pole_thresh(size>>3);
 	wr_scale = 1.0/max(0.01, (1.0 - water));
-
-	for (unsigned i = 0; i < table_size; ++i) { // build sin table
-		unsigned const offset(i*num_sines);
-		float const sarg(i/mt2 - 1.0);
-
-		for (unsigned k = 0; k < num_sines; ++k) { // create x and y tables
-			unsigned const index2(NUM_SINE_PARAMS*k);
-			xtable[offset+k] = SINF(rdata[index2+1]*sarg + rdata[index2+2]);
-			ytable[offset+k] = SINF(rdata[index2+3]*sarg + rdata[index2+4]);
+	vector<float> &heightmap(surface->heightmap);
+
+	if (!surface_hmap_cache.lookup(rgen, size, heightmap)) { // not cached, generate it
+		unsigned const table_size(MAX_TEXTURE_SIZE << 1); // larger is more accurate
+		static float xtable[TOT_NUM_SINES*table_size] = {}, ytable[TOT_NUM_SINES*table_size] = {};
+		unsigned const num_sines(surface->num_sines);
+		float const *const rdata(surface->rdata);
+		float const mt2(0.5*(table_size-1)), scale(1.5/surface->max_mag);
+		float const delta(TWO_PI/size), sin_ds(sin(delta)), cos_ds(cos(delta));
+		unsigned const pole_thresh(size>>3);
+
+		for (unsigned i = 0; i < table_size; ++i) { // build sin table
+			unsigned const offset(i*num_sines);
+			float const sarg(i/mt2 - 1.0);
+
+			for (unsigned k = 0; k < num_sines; ++k) { // create x and y tables
+				unsigned const index2(NUM_SINE_PARAMS*k);
+				xtable[offset+k] = SINF(rdata[index2+1]*sarg + rdata[index2+2]);
+				ytable[offset+k] = SINF(rdata[index2+3]*sarg + rdata[index2+4]);
+			}
 		}
+		#pragma omp parallel for schedule(dynamic,1)
+		for (int i = 0; i < (int)size; ++i) { // phi values
+			unsigned const hmoff(i*size);
+			float const phi((float(i)/(size-1))*PI);
+			float const sin_phi((i == int(size-1)) ? 0.0 : sinf(phi)), zval((i == int(size-1)) ? -1.0 : cosf(phi));
+			bool const near_pole(i <= (int)pole_thresh || i >= int(size-pole_thresh-1));
+			float sin_s(0.0), cos_s(1.0);
+			float ztable[TOT_NUM_SINES] = {};
+
+			for (unsigned k = 0; k < num_sines; ++k) { // create z table
+				unsigned const index2(NUM_SINE_PARAMS*k);
+				ztable[k] = rdata[index2]*SINF(rdata[index2+5]*zval + rdata[index2+6]);
+			}
+			for (unsigned j = 0; j < size; ++j) { // theta values, Note: x and y are swapped because theta is out of phase by 90 degrees to match tex coords
+				float const s(sin_s), c(cos_s), xval(sin_phi*s), yval(sin_phi*c);
+				float val(0.0);
+
+				if (near_pole) { // slower version near the poles
+					for (unsigned k = 0; k < num_sines; ++k) {
+						unsigned const index2(NUM_SINE_PARAMS*k);
+						val += ztable[k]*SINF(rdata[index2+1]*xval + rdata[index2+2])*SINF(rdata[index2+3]*yval + rdata[index2+4]);
+					}
+				}
+				else {
+					// Note: chooses the closest precomputed grid point for efficiency -
+					// no interpolation, so has artifacts closer to the poles
+					float const *const xv(xtable + (unsigned((xval+1.0)*mt2))*num_sines), *const yv(ytable + (unsigned((yval+1.0)*mt2))*num_sines);
+					float vals[4] = {}; // independent partial sums so that the compiler can use SIMD; num_sines is a multiple of 4
+					for (unsigned k = 0; k < num_sines; k += 4) {UNROLL_4X(vals[i_] += ztable[k+i_]*xv[k+i_]*yv[k+i_];)}
+					val = (vals[0] + vals[1]) + (vals[2] + vals[3]);
+				}
+				heightmap[hmoff + j] = 0.5*(max(-1.0f, min(1.0f, scale*val)) + 1.0);
+				sin_s = s*cos_ds + c*sin_ds;
+				cos_s = c*cos_ds - s*sin_ds;
+			} // for j
+		} // for i
+		surface_hmap_cache.add(rgen, size, heightmap);
 	}
-
-	#pragma omp parallel for schedule(dynamic,1)
+	// colors depend on water, temp, etc. which may change, so they're always recomputed from the (possibly cached) heightmap
+	#pragma omp parallel for schedule(static,1)
 	for (int i = 0; i < (int)size; ++i) { // phi values
-		unsigned const hmoff(i*size), ti(size-i-1), texoff(ti*size);
+		unsigned const hmoff(i*size), texoff((size-i-1)*size);
 		float const phi((float(i)/(size-1))*PI);
-		float const sin_phi((i == int(size-1)) ? 0.0 : sinf(phi)), zval((i == int(size-1)) ? -1.0 : cosf(phi));
-		float sin_s(0.0), cos_s(1.0);
-		float ztable[TOT_NUM_SINES] = {};
-
-		for (unsigned k = 0; k < num_sines; ++k) { // create z table
-			unsigned const index2(NUM_SINE_PARAMS*k);
-			ztable[k] = rdata[index2]*SINF(rdata[index2+5]*zval + rdata[index2+6]);
-		}
-		for (unsigned j = 0; j < size; ++j) { // theta values, Note: x and y are swapped because theta is out of phase by 90 degrees to match tex coords
-			float const s(sin_s), c(cos_s), xval(sin_phi*s), yval(sin_phi*c);
-			unsigned const tj(size-j-1), index(3*(texoff + tj));
-			unsigned const ox1((unsigned((xval+1.0)*mt2))*num_sines), oy1((unsigned((yval+1.0)*mt2))*num_sines);
-			float val(0.0);
-
-			if (i <= (int)pole_thresh || i >= int(size-pole_thresh-1)) { // slower version near the poles
-				for (unsigned k = 0; k < num_sines; ++k) {
-					unsigned const index2(NUM_SINE_PARAMS*k);
-					val += ztable[k]*SINF(rdata[index2+1]*xval + rdata[index2+2])*SINF(rdata[index2+3]*yval + rdata[index2+4]);
-				}
-			}
-			else {
-				// Note: chooses the closest precomputed grid point for efficiency -
-				// no interpolation, so has artifacts closer to the poles
-				for (unsigned k = 0; k < num_sines; ++k) {val += ztable[k]*xtable[ox1+k]*ytable[oy1+k];}
-			}
-			val = 0.5*(max(-1.0f, min(1.0f, scale*val)) + 1.0);
-			surface->heightmap[hmoff + j] = val;
-			get_surface_color((data + index), val, phi);
-			sin_s = s*cos_ds + c*sin_ds;
-			cos_s = c*cos_ds - s*sin_ds;
-		} // for j
-	} // for i
+		for (unsigned j = 0; j < size; ++j) {get_surface_color((data + 3*(texoff + (size-j-1))), heightmap[hmoff + j], phi);}
+	}
 	//if (size >= MAX_TEXTURE_SIZE) PRINT_TIME("Gen");
 }
 
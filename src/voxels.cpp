@@ -674,6 +674,7 @@ void voxel_model::remove_unconnected_outside_modified_blocks(bool postproc_brush
 		for (vector<unsigned>::const_iterator i = xy_updated.begin(); i != xy_updated.end(); ++i) {
 			unsigned const x((*i)%nx), y((*i)/nx);
 			assert(x < nx && y < ny);
+			modified_cols.add_column(x, y);
 			unsigned const bx1(max(0, (int)x-1)/xblocks), by1(max(0, (int)y-1)/yblocks);
 			unsigned const bx2(min((int)nx-1, (int)x+1)/xblocks), by2(min((int)nx-1, (int)y+1)/yblocks);
 		
@@ -755,76 +756,99 @@ void voxel_manager::flood_fill_range(unsigned x1, unsigned y1, unsigned x2, unsi
 
 
 // outside: 0=inside, 1=outside, 2=on_edge, 4-bit set=anchored, 8-bit set=under mesh
-// NOTE: not thread safe due to class member <work>
+// finds connected components of inside voxels with a union-find: xy tiles are processed in parallel, then merged across tile boundaries;
+// a component is anchored if it contains or is adjacent to a seed voxel (mesh surface, scene edge, or sphere center)
+// NOTE: not thread safe due to class member <temp_uf>
 void voxel_manager::remove_unconnected_outside_range(bool keep_at_edge, unsigned x1, unsigned y1, unsigned x2, unsigned y2,
 	vector<unsigned> *xy_updated, vector<pt_ix_t> *updated_pts, bool mark_only)
 {
 	//timer_t timer("Remove Unconnected");
 	assert(!outside.empty());
-	vector<unsigned> &work(temp_work); // stack of voxels to process
-	assert(work.empty());
-
-	if (params.atten_sphere_mode() || !use_mesh) { // sphere mode / not mesh mode
-		unsigned const x(nx/2), y(ny/2); // add a single point at the center of the sphere (will only work for filled sphere center)
-
-		if (x >= x1 && x <= x2 && y >= y1 && y <= y2) {
-			unsigned const ix(outside.get_ix(x, y, nz/2));
-			assert(outside[ix] != UNDER_MESH_BIT); // outside or above mesh
-			work.push_back(ix); // inside, anchored to the mesh
-			outside[ix] |= ANCHORED_BIT; // mark as anchored
+	assert(x1 < x2 && y1 < y2 && x2 <= nx && y2 <= ny);
+	unsigned const TILE_SZ = 16; // in voxel columns
+	unsigned const xsz(x2 - x1), ysz(y2 - y1), nxt((xsz + TILE_SZ - 1)/TILE_SZ), nyt((ysz + TILE_SZ - 1)/TILE_SZ);
+	bool const sphere_mode(params.atten_sphere_mode() || !use_mesh);
+	unsigned center_ix(outside.size()); // invalid
+
+	if (sphere_mode) { // add a single point at the center of the sphere (will only work for filled sphere center)
+		unsigned const x(nx/2), y(ny/2);
+
+		if (x >= x1 && x < x2 && y >= y1 && y < y2) {
+			center_ix = outside.get_ix(x, y, nz/2);
+			assert(outside[center_ix] != UNDER_MESH_BIT); // outside or above mesh
 		}
 	}
-	else { // add voxels along the mesh surface
-		for (unsigned y = y1; y < y2; ++y) {
-			for (unsigned x = x1; x < x2; ++x) {
-				unsigned ix(outside.get_ix(x, y, 0));
+	auto get_local_ix = [&](unsigned x, unsigned y, unsigned z) {return (z + ((x - x1) + (y - y1)*xsz)*nz);};
+	
+	auto is_seed = [&](unsigned x, unsigned y, unsigned ix) -> bool { // voxel anchored to the mesh or scene edge
+		unsigned char const val(outside[ix]);
+		if (sphere_mode ? (ix == center_ix) : (val == UNDER_MESH_BIT)) return 1;
+		return (keep_at_edge && val != 1 && (x == x1 || x+1 == x2 || y == y1 || y+1 == y2)); // on scene edge and not outside
+	};
+	auto is_node = [&](unsigned x, unsigned y, unsigned ix) {return (outside[ix] == 0 || is_seed(x, y, ix));};
+	// joins two adjacent voxels if at least one is inside; seeds only connect through inside voxels
+	auto try_join = [&](unsigned x, unsigned y, unsigned z, unsigned xn, unsigned yn, unsigned zn) {
+		unsigned const ix(outside.get_ix(x, y, z)), ixn(outside.get_ix(xn, yn, zn));
+		if (outside[ix] != 0 && outside[ixn] != 0) return;
+		if (!is_node(x, y, ix) || !is_node(xn, yn, ixn)) return;
+		temp_uf.join(get_local_ix(x, y, z), get_local_ix(xn, yn, zn));
+	};
+	temp_uf.init(xsz*ysz*nz);
 
-				for (unsigned ix_end = ix + nz; ix < ix_end; ++ix) {
-					if (outside[ix] != UNDER_MESH_BIT) continue; // outside or above mesh
-					work.push_back(ix); // inside, anchored to the mesh
-					outside[ix] |= ANCHORED_BIT; // mark as anchored
+	#pragma omp parallel for schedule(dynamic,1)
+	for (int t = 0; t < int(nxt*nyt); ++t) { // union voxels within each tile; tiles write to disjoint sets
+		unsigned const tx1(x1 + (t%nxt)*TILE_SZ), ty1(y1 + (t/nxt)*TILE_SZ), tx2(min(x2, tx1+TILE_SZ)), ty2(min(y2, ty1+TILE_SZ));
+
+		for (unsigned y = ty1; y < ty2; ++y) {
+			for (unsigned x = tx1; x < tx2; ++x) {
+				for (unsigned z = 0; z < nz; ++z) {
+					unsigned const ix(outside.get_ix(x, y, z));
+					if (!is_node(x, y, ix)) continue;
+					if (is_seed(x, y, ix)) {temp_uf.set_anchored(get_local_ix(x, y, z));}
+					if (z > 0  ) {try_join(x, y, z, x, y, z-1);}
+					if (x > tx1) {try_join(x, y, z, x-1, y, z);}
+					if (y > ty1) {try_join(x, y, z, x, y-1, z);}
 				}
 			}
 		}
 	}
+	// merge sets across tile boundaries
+	for (unsigned y = y1; y < y2; ++y) {
+		bool const y_tile_edge(y > y1 && ((y - y1) % TILE_SZ) == 0);
 
-	// add voxels along the scene x/y boundary
-	if (keep_at_edge) {
-		for (unsigned y = y1; y < y2; ++y) {
-			for (unsigned x = x1; x < x2; ++x) {
-				if (x != x1 && x+1 != x2 && y != y1 && y+1 != y2) continue; // not on scene edge
+		for (unsigned x = x1; x < x2; ++x) {
+			bool const x_tile_edge(x > x1 && ((x - x1) % TILE_SZ) == 0);
+			if (!x_tile_edge && !y_tile_edge) continue;
 
-				for (unsigned z = 0; z < nz; ++z) {
-					unsigned const ix(outside.get_ix(x, y, z));
-					if (outside[ix] == 1) continue; // outside
-					work.push_back(ix); // inside, anchored to the mesh
-					outside[ix] |= ANCHORED_BIT; // mark as anchored
-				}
+			for (unsigned z = 0; z < nz; ++z) {
+				if (x_tile_edge) {try_join(x, y, z, x-1, y, z);}
+				if (y_tile_edge) {try_join(x, y, z, x, y-1, z);}
 			}
 		}
 	}
-	flood_fill_range(x1, y1, x2, y2, work, 0, ANCHORED_BIT); // fill inside voxels (anchor regions)
+	// mark inside voxels not connected to an anchor as outside
+	vector<vector<pt_ix_t>> row_updated_pts(updated_pts ? ysz : 0);
+	vector<vector<unsigned>> row_xy_updated(xy_updated ? ysz : 0);
+
+	#pragma omp parallel for schedule(static,1)
+	for (int yy = 0; yy < (int)ysz; ++yy) {
+		unsigned const y(y1 + yy);
 
-	// if anchored or on_edge remove the anchored bit, else mark outside
-	for (unsigned y = y1; y < y2; ++y) {
 		for (unsigned x = x1; x < x2; ++x) {
 			bool had_update(0);
 
 			for (unsigned z = 0; z < nz; ++z) {
 				unsigned const ix(outside.get_ix(x, y, z));
-
-				if (outside[ix] > 1) { // anchored, on edge, or under mesh
-					outside[ix] &= ~ANCHORED_BIT; // remove anchored bit
-				}
-				else if (outside[ix] != 1) { // inside and non-anchored
-					if (updated_pts) {updated_pts->push_back(pt_ix_t(get_pt_at(x, y, z), ix));}
-					if (!mark_only ) {make_voxel_outside(ix);}
-					had_update = 1;
-				}
+				if (outside[ix] != 0 || temp_uf.is_anchored(get_local_ix(x, y, z))) continue; // not inside, or inside and anchored
+				if (updated_pts) {row_updated_pts[yy].push_back(pt_ix_t(get_pt_at(x, y, z), ix));}
+				if (!mark_only ) {make_voxel_outside(ix);}
+				had_update = 1;
 			}
-			if (had_update && xy_updated) {xy_updated->push_back(y*nx + x);}
+			if (had_update && xy_updated) {row_xy_updated[yy].push_back(y*nx + x);}
 		}
 	}
+	for (unsigned yy = 0; yy < row_updated_pts.size(); ++yy) {vector_add_to(row_updated_pts[yy], *updated_pts);}
+	for (unsigned yy = 0; yy < row_xy_updated .size(); ++yy) {vector_add_to(row_xy_updated [yy], *xy_updated );}
 }
 
 
@@ -1028,6 +1052,7 @@ void voxel_model::clear() {
 	}
 	modified_blocks.clear();
 	next_frame_modified_blocks.clear();
+	modified_cols.clear();
 	ao_lighting.clear();
 	voxel_manager::clear();
 	volume_added = 0;
@@ -1193,22 +1218,44 @@ void voxel_model::calc_ao_dirs() {
 }
 
 
-void voxel_model::calc_ao_lighting_for_block(unsigned block_ix, bool increase_only) {
+// if cols is non-null, only voxel columns within AO ray range of cols are updated
+void voxel_model::calc_ao_lighting_for_blocks(vector<unsigned> const &blocks, bool increase_only, column_range_t const *cols) {
 
-	if (ao_lighting.empty()) return; // nothing to do
+	if (ao_lighting.empty() || blocks.empty()) return; // nothing to do
 	float const norm(params.ao_weight_scale/ao_dirs.size());
-	unsigned const xbix(block_ix%params.num_blocks), ybix(block_ix/params.num_blocks);
 	unsigned char const end_ray_flags((display_mode & 0x01) ? UNDER_MESH_BIT : 0);
 	unsigned const xstep(use_mesh ? max(1U, nx/MESH_X_SIZE ) : 1U);
 	unsigned const ystep(use_mesh ? max(1U, ny/MESH_Y_SIZE ) : 1U);
 	unsigned const zstep(use_mesh ? max(1U, nz/MESH_SIZE[2]) : 1U);
-	unsigned const x_end(min(nx, (xbix+1)*xblocks)), y_end(min(ny, (ybix+1)*yblocks));
 	unsigned const voxel_sz[3] = {nx, ny, nz};
-	
+	unsigned cx1(0), cy1(0), cx2(nx), cy2(ny); // range of columns to update
+
+	if (cols) { // expand modified columns by the max AO ray length in x and y, plus 1 for the positive step bias and 1 for rounding
+		assert(!cols->is_empty());
+		unsigned pad[2] = {0, 0};
+		for (step_dir_t const &d : ao_dirs) {UNROLL_2X(if (d.dir[i_]) {pad[i_] = max(pad[i_], d.nsteps);});}
+		UNROLL_2X(pad[i_] += 2;);
+		cx1 = ((cols->x1 > pad[0]) ? (cols->x1 - pad[0]) : 0); cx2 = min(nx, (cols->x2 + pad[0]));
+		cy1 = ((cols->y1 > pad[1]) ? (cols->y1 - pad[1]) : 0); cy2 = min(ny, (cols->y2 + pad[1]));
+	}
+	vector<pair<unsigned, unsigned>> rows; // {block_ix, yi}; each row is processed independently and writes to disjoint voxels
+
+	for (unsigned block_ix : blocks) {
+		unsigned const ybix(block_ix/params.num_blocks), y_end(min(ny, (ybix+1)*yblocks));
+
+		for (unsigned yi = ybix*yblocks; yi < y_end; yi += ystep) {
+			if (yi + ystep > cy1 && yi < cy2) {rows.emplace_back(block_ix, yi);}
+		}
+	}
 	#pragma omp parallel for schedule(dynamic,1)
-	for (int yi = ybix*yblocks; yi < (int)y_end; yi += ystep) {
+	for (int r = 0; r < (int)rows.size(); ++r) {
+		unsigned const block_ix(rows[r].first), yi(rows[r].second);
+		unsigned const xbix(block_ix%params.num_blocks), ybix(block_ix/params.num_blocks);
+		unsigned const x_end(min(nx, (xbix+1)*xblocks)), y_end(min(ny, (ybix+1)*yblocks));
+
 		for (unsigned xi = xbix*xblocks; xi < x_end; xi += xstep) {
-			if (xi == 0 || yi == 0 || xi >= nx-xstep || (unsigned)yi >= ny-ystep) continue; // at the mesh edges
+			if (xi + xstep <= cx1 || xi >= cx2) continue; // outside the update range
+			if (xi == 0 || yi == 0 || xi >= nx-xstep || yi >= ny-ystep) continue; // at the mesh edges
 			bool saw_inside(0);
 
 			for (int zi = nz-2; zi >= 0; zi -= zstep) { // skip top zval
@@ -1255,13 +1302,13 @@ void voxel_model::calc_ao_lighting_for_block(unsigned block_ix, bool increase_on
 				}
 			} // for z
 		} // for x
-	} // for y
+	} // for row
 }
 
 
-void voxel_model_space::calc_ao_lighting_for_block(unsigned block_ix, bool increase_only) {
+void voxel_model_space::calc_ao_lighting_for_blocks(vector<unsigned> const &blocks, bool increase_only, column_range_t const *cols) {
 
-	voxel_model::calc_ao_lighting_for_block(block_ix, increase_only);
+	voxel_model::calc_ao_lighting_for_blocks(blocks, increase_only, cols);
 	free_ao_and_shadow_texture(); // will be recalculated if needed
 }
 
@@ -1272,10 +1319,9 @@ void voxel_model::calc_ao_lighting() {
 	if (params.ao_radius == 0.0 || params.ao_weight_scale == 0.0) return; // no AO lighting
 	ao_lighting.init(nx, ny, nz, vsz, center, 255, params.num_blocks);
 	calc_ao_dirs();
-
-	for (unsigned block = 0; block < tri_data[0].size(); ++block) {
-		calc_ao_lighting_for_block(block, 0);
-	}
+	vector<unsigned> blocks(tri_data[0].size());
+	for (unsigned block = 0; block < blocks.size(); ++block) {blocks[block] = block;}
+	calc_ao_lighting_for_blocks(blocks, 0);
 }
 
 
@@ -1319,6 +1365,7 @@ bool voxel_model::update_voxel_sphere_region(point const &center, float radius,
 				if (damage_pos) {*damage_pos = pos;}
 			}
 			if (!was_updated) continue;
+			modified_cols.add_column(x, y);
 			// check adjacent voxels since we will need to update our neighbors at the boundaries
 			unsigned const bx1(max((int)x-1, 0        )/xblocks), by1(max((int)y-1, 0        )/yblocks);
 			unsigned const bx2(min((int)x+1, (int)nx-1)/xblocks), by2(min((int)y+1, (int)ny-1)/yblocks);
@@ -1409,14 +1456,14 @@ void voxel_model::proc_pending_updates(bool postproc_brushes_mode) {
 				update_boundary_normals_for_block(blocks_to_update[i], 0);
 			}
 		}
-		for (unsigned i = 0; i < blocks_to_update.size(); ++i) { // blocks will be sorted by y then x
-			calc_ao_lighting_for_block(blocks_to_update[i], !volume_added); // update can only remove, so lighting can only increase
-		}
+		// update can only remove, so lighting can only increase; only columns within AO range of the modified columns can change
+		if (!modified_cols.is_empty()) {calc_ao_lighting_for_blocks(blocks_to_update, !volume_added, &modified_cols);}
 		update_blocks_hook(blocks_to_update, tot_num_added);
 		//PRINT_TIME(postproc_brushes_mode ? "  Process Voxel Updates" : "Process Voxel Updates");
 	}
 	modified_blocks = next_frame_modified_blocks;
 	next_frame_modified_blocks.clear();
+	modified_cols.clear();
 	volume_added = 0;
 }
 
@@ -1529,6 +1576,7 @@ void voxel_model::build(bool verbose, bool do_ao_lighting) {
 	if (params.remove_unconnected > 0) {remove_unconnected_outside();}
 	if (params.remove_unconnected > 2) {remove_interior_holes();}
 	remove_excess_cap(temp_work);
+	temp_uf.free_mem();
 	if (verbose) {PRINT_TIME("  Remove Unconnected");}
 	unsigned const tot_blocks(params.num_blocks*params.num_blocks);
 	assert(pt_to_ix[0].empty() && tri_data[0].empty());
@@ -155,13 +155,45 @@ public:
 typedef voxel_grid<float> float_voxel_grid;
 
 
+class voxel_union_find_t { // disjoint sets of voxels, where each set is anchored if any of its voxels is anchored
+	vector<unsigned> parent;
+	vector<unsigned char> anchored;
+public:
+	void init(unsigned sz) {
+		parent.resize(sz);
+		anchored.resize(sz);
+		for (unsigned i = 0; i < sz; ++i) {parent[i] = i;}
+		std::fill(anchored.begin(), anchored.end(), 0);
+	}
+	unsigned find(unsigned i) { // with path halving
+		while (parent[i] != i) {parent[i] = parent[parent[i]]; i = parent[i];}
+		return i;
+	}
+	unsigned find_const(unsigned i) const { // no path compression, so safe to call from multiple threads
+		while (parent[i] != i) {i = parent[i];}
+		return i;
+	}
+	void join(unsigned a, unsigned b) {
+		a = find(a); b = find(b);
+		if (a == b) return;
+		if (a > b) {std::swap(a, b);}
+		parent[b] = a;
+		anchored[a] |= anchored[b];
+	}
+	void set_anchored(unsigned i) {anchored[find(i)] = 1;}
+	bool is_anchored (unsigned i) const {return anchored[find_const(i)];}
+	void free_mem() {remove_excess_cap(parent); remove_excess_cap(anchored);}
+};
+
+
 class voxel_manager : public float_voxel_grid {
 
 protected:
 	bool use_mesh=0;
 	voxel_params_t params;
 	voxel_grid<unsigned char> outside;
-	vector<unsigned> temp_work; // used in remove_unconnected_outside_range()/flood_fill()
+	vector<unsigned> temp_work; // used in remove_interior_holes()/flood_fill()
+	voxel_union_find_t temp_uf; // used in remove_unconnected_outside_range()
 	typedef vert_norm vertex_type_t;
 	typedef vntc_vect_block_t<vertex_type_t> tri_data_t;
 	typedef vertex_map_t<vertex_type_t> vertex_map_type_t;
@@ -234,6 +266,18 @@ protected:
 	std::set<unsigned> modified_blocks, next_frame_modified_blocks;
 	voxel_grid<unsigned char> ao_lighting;
 
+	struct column_range_t { // xy range of voxel columns modified since the last update: [x1,x2) x [y1,y2)
+		unsigned x1=0, y1=0, x2=0, y2=0;
+
+		bool is_empty() const {return (x1 >= x2 || y1 >= y2);}
+		void clear() {x1 = y1 = x2 = y2 = 0;}
+		void add_column(unsigned x, unsigned y) {
+			if (is_empty()) {x1 = x; y1 = y; x2 = x+1; y2 = y+1;}
+			else {x1 = min(x1, x); y1 = min(y1, y); x2 = max(x2, x+1); y2 = max(y2, y+1);}
+		}
+	};
+	column_range_t modified_cols;
+
 	struct step_dir_t {
 		unsigned nsteps;
 		float nsteps_inv;
@@ -270,7 +314,7 @@ protected:
 	void update_boundary_normals_for_block(unsigned block_ix, bool calc_average);
 	void finalize_boundary_vmap();
 	void calc_ao_dirs();
-	virtual void calc_ao_lighting_for_block(unsigned block_ix, bool increase_only);
+	virtual void calc_ao_lighting_for_blocks(vector<unsigned> const &blocks, bool increase_only, column_range_t const *cols=nullptr);
 	void calc_ao_lighting();
 
 	virtual void maybe_create_fragments(point const &center, float radius, int shooter, unsigned num_fragments, bool directly_from_update) const {} // do nothing
@@ -339,7 +383,7 @@ public:
 
 class voxel_model_rock : public voxel_model {
 
-	virtual void calc_ao_lighting_for_block(unsigned block_ix, bool increase_only) {} // do nothing
+	virtual void calc_ao_lighting_for_blocks(vector<unsigned> const &blocks, bool increase_only, column_range_t const *cols=nullptr) {} // do nothing
 public:
 	voxel_model_rock(noise_texture_manager_t *ntg, unsigned num_lod_levels) : voxel_model(ntg, 0, num_lod_levels) {}
 	void build(bool verbose) {voxel_model::build(verbose, 0);}
@@ -352,7 +396,7 @@ class voxel_model_space : public voxel_model {
 	vector<triangle> shadow_edge_tris;
 
 	void free_ao_and_shadow_texture() {free_texture(ao_tid); free_texture(shadow_tid);}
-	virtual void calc_ao_lighting_for_block(unsigned block_ix, bool increase_only);
+	virtual void calc_ao_lighting_for_blocks(vector<unsigned> const &blocks, bool increase_only, column_range_t const *cols=nullptr);
 	void calc_shadows(voxel_grid<unsigned char> &shadow_data) const;
 	void extract_shadow_edges(voxel_grid<unsigned char> const &shadow_data);
 
@@ -7,7 +7,9 @@
 #include "physics_objects.h"
 #include "player_state.h"
 #include "shaders.h"
+#include "file_utils.h"
 #include <queue>
+#include <cfloat> // for FLT_MAX
 
 
 int const WP_RESET_FRAMES      = 100; // Note: in frames, not ticks, fix?
@@ -15,10 +17,15 @@ int const WP_RECENT_FRAMES     = 200;
 float const MAX_FALL_DIST_MULT = 20.0;
 float const STEP_SIZE_MULT     = 0.25; // waypoint connectivity algorithm (relative to smiley radius)
 float const STEP_SIZE_MULT2    = 0.50; // reachability tests (relative to smiley radius)
+unsigned const wgraph_header_sig  = 0xdeadbeef;
+unsigned const wgraph_trailer_sig = 0xbeefdead;
+unsigned const wgraph_version     = 1; // increment when the graph algorithm or file format changes to invalidate cached graphs
 
 bool has_user_placed(0), has_item_placed(0), has_wpt_goal(0);
 int show_waypoints(0); // 0=none, 1=waypoints, 2=waypoints+edges
 waypoint_vector waypoints;
+string waypoint_cache_dir; // empty = don't cache the waypoint graph
+unsigned wpt_graph_version(0); // incremented when waypoints or their edges change
 
 extern bool use_waypoints;
 extern int DISABLE_WATER, camera_change, frame_counter, num_smileys, num_groups, display_mode;
@@ -342,6 +349,7 @@ public:
 
 	unsigned add_new_waypoint(point const &pos, int coll_id, bool connect_in, bool connect_out, bool goal, bool temp) {
 		unsigned const ix(waypoints.add(waypoint_t(pos, coll_id, 0, 0, goal, temp)));
+		++wpt_graph_version;
 		if (connect_in ) connect_waypoints(0,  ix,    ix, ix+1, 0, 1); // from existing waypoints to new waypoint
 		if (connect_out) connect_waypoints(ix, ix+1,  0,  ix,   0, 1); // from new waypoint to existing waypoints
 		return ix;
@@ -371,6 +379,7 @@ public:
 	void disconnect_waypoint(unsigned ix, bool is_last) {
 		assert(ix < waypoints.size());
 		waypoint_t &w(waypoints[ix]);
+		++wpt_graph_version;
 		
 		for (waypt_adj_vect::const_iterator i = w.prev_wpts.begin(); i != w.prev_wpts.end(); ++i) {
 			assert(*i < waypoints.size());
@@ -411,86 +420,114 @@ public:
 	}
 
 	void connect_all_waypoints() {
-		connect_waypoints(0, (unsigned)waypoints.size(), 0, (unsigned)waypoints.size(), 1, 0);
+		unsigned const num(waypoints.size());
+		++wpt_graph_version;
+		string const cache_fn(get_graph_cache_fn());
+		if (!cache_fn.empty() && read_graph(cache_fn)) return;
+		connect_waypoints(0, num, 0, num, 1, 0);
+		if (!cache_fn.empty()) {write_graph(cache_fn);}
 	}
 
+	// two phases so that the result doesn't depend on thread scheduling:
+	// 1. in parallel, find visible and reachable candidate edges for each waypoint independently
+	// 2. in parallel, prune redundant edges using only the (read-only) results of phase 1, then add the edges in waypoint order
 	void connect_waypoints(unsigned from_start, unsigned from_end, unsigned to_start,
 		unsigned to_end, bool verbose, bool fast)
 	{
 		unsigned visible(0), cand_edges(0), num_edges(0), tot_steps(0);
 		float const fast_dmax(0.25f*(X_SCENE_SIZE + Y_SCENE_SIZE));
-		for (int i = from_start; i < (int)from_end; ++i) {waypoints[i].next_valid = 0;}
+		unsigned const num_from(from_end - from_start);
+		vector<waypt_adj_vect> new_edges(num_from), kept_edges(num_from);
 		vector<pair<float, unsigned> > cands;
+		vector<vector3d> edge_dirs;
 
-		#pragma omp parallel for schedule(dynamic,1) private(cands) // is this fully thread safe? it's not determinstic across threads
+		#pragma omp parallel for schedule(dynamic,1) private(cands, edge_dirs) reduction(+:visible, cand_edges, tot_steps)
 		for (int i = from_start; i < (int)from_end; ++i) {
 			assert(i < (int)waypoints.size());
 			if (waypoints[i].disabled) continue;
 			point const start(waypoints[i].pos);
 			int cindex(-1);
+			unsigned steps(0); // per-waypoint so that the step limit in is_point_reachable() is independent of other threads
 			cands.clear();
+			edge_dirs.clear();
 
 			for (unsigned j = to_start; j < to_end; ++j) {
 				if (i == (int)j || waypoints[j].disabled) continue;
-
-				if (waypoints[i].connected_to == (int)j) { // connected by a teleporter
-					cands.push_back(make_pair(CAMERA_RADIUS, j)); // small but nonzero distance
-					continue;
-				}
-				point const end(waypoints[j].pos);
-				if (cindex >= 0 && coll_objects.get_cobj(cindex).line_intersect(start, end)) continue; // hit last cobj
-				if (fast && !dist_less_than(start, end, fast_dmax)) continue; // too far away
-				if (check_coll_line(start, end, cindex, -1, 1, 0, 1, 0, 1)) continue; // no line of sight (skip dynamic/movable)
-				cands.push_back(make_pair(p2p_dist_sq(start, end), j));
-				++visible;
+				if (waypoints[i].connected_to == (int)j) {cands.push_back(make_pair(CAMERA_RADIUS, j)); continue;} // teleporter: small but nonzero distance
+				float const dist_sq(p2p_dist_sq(start, waypoints[j].pos));
+				if (fast && dist_sq > fast_dmax*fast_dmax) continue; // too far away
+				cands.push_back(make_pair(dist_sq, j));
 			}
 			sort(cands.begin(), cands.end()); // closest to furthest
-			waypt_adj_vect &next(waypoints[i].next_wpts);
-
+			waypt_adj_vect const &next(waypoints[i].next_wpts); // existing edges
+			waypt_adj_vect &new_next(new_edges[i - from_start]);
+
+			for (unsigned l = 0; l < next.size(); ++l) {
+				assert(next[l] < waypoints.size());
+				if (next[l] < to_start || next[l] >= to_end) continue; // not in the target range
+				vector3d const dir2(waypoints[next[l]].pos - start);
+				edge_dirs.push_back(vector3d(dir2.x, dir2.y, 0.0).get_norm());
+			}
 			for (unsigned j = 0; j < cands.size(); ++j) {
 				unsigned const k(cands[j].second);
 				assert(k < waypoints.size());
 				point const end(waypoints[k].pos);
 				vector3d const dir(end - start), dir_xy(vector3d(dir.x, dir.y, 0.0).get_norm());
-				bool colinear(0), redundant(0);
-
-				for (unsigned l = 0; l < next.size() && !colinear; ++l) {
-					assert(next[l] < waypoints.size());
-					if (next[l] < to_start || next[l] >= to_end) continue; // no in the target range
-					vector3d const dir2(waypoints[next[l]].pos - start), dir_xy2(vector3d(dir2.x, dir2.y, 0.0).get_norm());
-					colinear = (dot_product(dir_xy, dir_xy2) > 0.99);
-				}
+				bool colinear(0);
+				// test direction against the closer edges first, since this is much cheaper than the line of sight query
+				for (unsigned l = 0; l < edge_dirs.size() && !colinear; ++l) {colinear = (dot_product(dir_xy, edge_dirs[l]) > 0.99);}
 				if (colinear) continue;
+				bool const teleport(waypoints[i].connected_to == (int)k);
 
-				for (unsigned l = 0; l < next.size() && !redundant; ++l) {
-					assert(next[l] < waypoints.size());
-					if (!waypoints[next[l]].next_valid) continue; // another thread is working on this waypoint, so don't use it
-					waypt_adj_vect const &next_next(waypoints[next[l]].next_wpts);
-					point const &wl(waypoints[next[l]].pos);
-
-					for (unsigned m = 0; m < next_next.size() && !redundant; ++m) {
-						assert(next_next[m] < waypoints.size());
-						point const &wm(waypoints[next_next[m]].pos);
-						redundant = (next_next[m] == k && (p2p_dist(start, wl) + p2p_dist(wl, wm) < 1.02f*p2p_dist(start, wm)));
-					}
-				}
-				if (redundant) continue;
-
-				if (waypoints[i].connected_to == (int)k || is_point_reachable(start, end, tot_steps, STEP_SIZE_MULT, 1)) {
-					next.push_back(k);
-					++num_edges;
+				if (!teleport) {
+					if (cindex >= 0 && coll_objects.get_cobj(cindex).line_intersect(start, end)) continue; // hit last cobj
+					if (check_coll_line(start, end, cindex, -1, 1, 0, 1, 0, 1)) continue; // no line of sight (skip dynamic/movable)
+					++visible;
 				}
 				++cand_edges;
+				if (!teleport && !is_point_reachable(start, end, steps, STEP_SIZE_MULT, 1)) continue;
+				new_next.push_back(k);
+				edge_dirs.push_back(dir_xy);
 			} // for j
-			waypoints[i].next_valid = 1;
-		}
+			tot_steps += steps;
+		} // for i
+		// an edge i=>k is redundant if there's a path i=>l=>k through two shorter edges that's nearly as short;
+		// requiring shorter edges means a redundant edge is always replaced by a path of edges that are kept
+		#pragma omp parallel for schedule(dynamic,16) reduction(+:num_edges)
+		for (int i = from_start; i < (int)from_end; ++i) {
+			waypt_adj_vect const &cand_next(new_edges[i - from_start]);
+			waypt_adj_vect &kept(kept_edges[i - from_start]);
+			point const &start(waypoints[i].pos);
+
+			for (unsigned j = 0; j < cand_next.size(); ++j) {
+				unsigned const k(cand_next[j]);
+				point const &end(waypoints[k].pos);
+				float const dist(p2p_dist(start, end));
+				bool redundant(0);
+
+				for (unsigned n = 0; n < 2 && !redundant; ++n) { // existing edges, then new edges
+					waypt_adj_vect const &next(n ? cand_next : waypoints[i].next_wpts);
+
+					for (unsigned l = 0; l < next.size() && !redundant; ++l) {
+						unsigned const wl(next[l]);
+						if (wl == k) continue;
+						point const &pl(waypoints[wl].pos);
+						float const dist_il(p2p_dist(start, pl)), dist_lk(p2p_dist(pl, end));
+						if (dist_il >= dist || dist_lk >= dist || dist_il + dist_lk >= 1.02f*dist) continue;
+						redundant = has_edge(wl, k, from_start, from_end, new_edges);
+					}
+				}
+				if (!redundant) {kept.push_back(k);}
+			} // for j
+			num_edges += kept.size();
+		} // for i
 		for (unsigned i = from_start; i < from_end; ++i) {
-			if (waypoints[i].disabled) continue;
-			waypt_adj_vect const &next(waypoints[i].next_wpts);
+			waypt_adj_vect const &kept(kept_edges[i - from_start]);
+			vector_add_to(kept, waypoints[i].next_wpts);
 
-			for (unsigned j = 0; j < next.size(); ++j) {
-				assert(next[j] < waypoints.size());
-				if (next[j] >= to_start && next[j] < to_end) {waypoints[next[j]].prev_wpts.push_back(i);}
+			for (unsigned j = 0; j < kept.size(); ++j) {
+				assert(kept[j] < waypoints.size());
+				waypoints[kept[j]].prev_wpts.push_back(i); // kept edges are always in the target range
 			}
 		}
 		if (verbose) {
@@ -499,6 +536,118 @@ public:
 		}
 	}
 
+	static bool has_edge(unsigned from, unsigned to, unsigned from_start, unsigned from_end, vector<waypt_adj_vect> const &new_edges) {
+		waypt_adj_vect const &next(waypoints[from].next_wpts);
+		if (find(next.begin(), next.end(), to) != next.end()) return 1;
+		if (from < from_start || from >= from_end) return 0;
+		waypt_adj_vect const &new_next(new_edges[from - from_start]);
+		return (find(new_next.begin(), new_next.end(), to) != new_next.end());
+	}
+
+	// the connectivity graph is cached on disk, keyed by a hash of everything that affects it
+	string get_graph_cache_fn() const {
+		if (waypoint_cache_dir.empty() || waypoints.empty()) return "";
+		unsigned hv(0);
+		hash_mix_val(wgraph_version, hv);
+		hash_mix_val(waypoints.size(), hv);
+		hash_mix_val(radius, hv);
+		hash_mix_val(water_plane_z, hv);
+		hash_mix_val(DISABLE_WATER, hv);
+
+		for (waypoint_t const &w : waypoints) {
+			hash_mix_point(w.pos, hv);
+			hash_mix_val(w.connected_to, hv);
+			hash_mix_val(w.disabled, hv);
+		}
+		for (coll_obj const &c : coll_objects) {
+			if (c.status != COLL_STATIC) continue;
+			hash_mix_val(c.type, hv);
+			hash_mix_val(c.platform_id, hv);
+			hash_mix_val(c.radius, hv);
+			hash_mix_val(c.radius2, hv);
+			hash_mix_val(c.thickness, hv);
+			hash_mix_point(c.get_llc(), hv);
+			hash_mix_point(c.get_urc(), hv);
+			for (int i = 0; i < c.npoints; ++i) {hash_mix_point(c.points[i], hv);}
+		}
+		hash_mix_val(MESH_X_SIZE, hv);
+		hash_mix_val(MESH_Y_SIZE, hv);
+		hash_mix_val(X_SCENE_SIZE, hv);
+		hash_mix_val(Y_SCENE_SIZE, hv);
+		hash_mix_val(jenkins_one_at_a_time_hash((uint8_t const *)mesh_height[0], XY_MULT_SIZE*sizeof(float)), hv);
+		std::ostringstream oss;
+		oss << waypoint_cache_dir << "/waypoints_" << std::hex << hv << ".graph";
+		return oss.str();
+	}
+	template<typename T> static void hash_mix_val(T const &v, unsigned &hv) {
+		hv += hash_by_bytes<T>()(v);
+		hv += hv << 10;
+		hv ^= hv >> 6;
+	}
+
+	static bool read_uint_checked(FILE *fp, unsigned &val) {return (fread(&val, sizeof(unsigned), 1, fp) == 1);} // returns 0 on a short read rather than asserting
+
+	bool read_graph(string const &fn) const {
+		FILE *fp(fopen(fn.c_str(), "rb"));
+		if (fp == NULL) return 0; // not yet cached
+		unsigned const num(waypoints.size());
+		unsigned header(0), file_num(0), trailer(0);
+
+		if (!read_uint_checked(fp, header) || !read_uint_checked(fp, file_num) || header != wgraph_header_sig || file_num != num) {
+			std::cerr << "Error: incorrect header found in waypoint graph file " << fn << "." << endl;
+			checked_fclose(fp);
+			return 0;
+		}
+		for (waypoint_t &w : waypoints) {w.next_wpts.clear(); w.prev_wpts.clear();}
+		unsigned num_edges(0);
+		bool valid(1);
+
+		for (unsigned i = 0; i < num && valid; ++i) {
+			waypt_adj_vect &next(waypoints[i].next_wpts);
+			unsigned num_next(0);
+			if (!read_uint_checked(fp, num_next) || num_next > num) {valid = 0; break;} // truncated or corrupt; each waypoint has at most num edges
+			next.resize(num_next);
+			if (next.empty()) continue;
+			valid &= (fread(next.data(), sizeof(wpt_ix_t), next.size(), fp) == next.size());
+			for (wpt_ix_t const k : next) {valid &= (k < num);}
+			num_edges += next.size();
+		}
+		valid &= (read_uint_checked(fp, trailer) && trailer == wgraph_trailer_sig);
+		checked_fclose(fp);
+
+		if (!valid) {
+			std::cerr << "Error reading waypoint graph file " << fn << "." << endl;
+			for (waypoint_t &w : waypoints) {w.next_wpts.clear();}
+			return 0;
+		}
+		for (unsigned i = 0; i < num; ++i) {
+			for (wpt_ix_t const k : waypoints[i].next_wpts) {waypoints[k].prev_wpts.push_back(i);}
+		}
+		cout << "Read waypoint graph " << fn << ": " << num << " waypoints, " << num_edges << " edges" << endl;
+		return 1;
+	}
+
+	bool write_graph(string const &fn) const {
+		FILE *fp(fopen(fn.c_str(), "wb"));
+
+		if (fp == NULL) {
+			std::cerr << "Error opening waypoint graph file " << fn << " for write" << endl;
+			return 0;
+		}
+		write_binary_uint(fp, wgraph_header_sig);
+		write_binary_uint(fp, waypoints.size());
+
+		for (waypoint_t const &w : waypoints) {
+			write_binary_uint(fp, w.next_wpts.size());
+			if (w.next_wpts.empty()) continue;
+			unsigned const elem_write(fwrite(w.next_wpts.data(), sizeof(wpt_ix_t), w.next_wpts.size(), fp));
+			assert(elem_write == w.next_wpts.size()); // add error checking?
+		}
+		write_binary_uint(fp, wgraph_trailer_sig);
+		checked_fclose(fp);
+		return 1;
+	}
+
 	bool check_cobj_placement(point &pos, int coll_id, bool check_uw) const {
 		if (check_uw && is_underwater(pos)) return 0;
 		dwobject obj(def_objects[WAYPOINT]); // create a temporary object
@@ -571,6 +720,95 @@ struct waypoint_cache {
 waypoint_cache global_wpt_cache;
 
 
+// reverse shortest path distances from a set of goal waypoints, shared by all smileys heading for the same goal(s);
+// a field is rebuilt lazily when the waypoint graph changes, which is much less frequent than path queries
+class wpt_goal_field_cache {
+
+	struct field_t {
+		vector<unsigned> goals;
+		vector<float> dist; // path distance to the closest goal; FLT_MAX if unreachable
+		unsigned graph_version=0, last_used=0;
+	};
+	vector<field_t> fields;
+	unsigned use_count=0;
+	static unsigned const MAX_FIELDS = 16;
+
+	void build(field_t &f) const {
+		std::priority_queue<pair<float, unsigned> > open_queue;
+		f.dist.clear();
+		f.dist.resize(waypoints.size(), FLT_MAX);
+		f.graph_version = wpt_graph_version;
+
+		for (unsigned g : f.goals) {
+			assert(g < waypoints.size());
+			f.dist[g] = 0.0;
+			open_queue.push(make_pair(0.0f, g));
+		}
+		while (!open_queue.empty()) { // Dijkstra's algorithm along incoming edges
+			float const cur_dist(-open_queue.top().first);
+			unsigned const cur(open_queue.top().second);
+			open_queue.pop();
+			if (cur_dist > f.dist[cur]) continue; // duplicate with a longer distance
+			waypt_adj_vect const &prev(waypoints[cur].prev_wpts);
+
+			for (auto i = prev.begin(); i != prev.end(); ++i) {
+				assert(*i < waypoints.size());
+				float const new_dist(cur_dist + get_edge_cost(*i, cur));
+				if (new_dist >= f.dist[*i]) continue; // not better
+				f.dist[*i] = new_dist;
+				open_queue.push(make_pair(-new_dist, *i));
+			}
+		} // end while()
+	}
+public:
+	// if not connected by a teleporter, use distance between the waypoints; otherswise, use a small but nonzero value
+	static float get_edge_cost(unsigned from, unsigned to) {
+		waypoint_t const &w(waypoints[from]);
+		return ((w.connected_to == (int)to) ? CAMERA_RADIUS : p2p_dist(w.pos, waypoints[to].pos));
+	}
+	void clear() {fields.clear();}
+
+	vector<float> const &get_dists(vector<unsigned> const &goals) {
+		field_t *f(nullptr);
+
+		for (field_t &field : fields) {
+			if (field.goals == goals) {f = &field; break;}
+		}
+		if (f == nullptr) { // add a new field, or replace the least recently used one
+			if (fields.size() < MAX_FIELDS) {fields.push_back(field_t());}
+			else {
+				for (field_t &field : fields) {
+					if (f == nullptr || field.last_used < f->last_used) {f = &field;}
+				}
+			}
+			if (f == nullptr) {f = &fields.back();}
+			f->goals = goals;
+			f->dist.clear(); // force a rebuild
+		}
+		if (f->graph_version != wpt_graph_version || f->dist.size() != waypoints.size()) {build(*f);}
+		f->last_used = ++use_count;
+		return f->dist;
+	}
+	static int get_next_waypoint(vector<float> const &dist, unsigned cur) { // returns -1 if no path
+		assert(cur < dist.size());
+		if (dist[cur] == 0.0)     return cur; // already at goal
+		if (dist[cur] == FLT_MAX) return -1;  // no path to goal
+		waypt_adj_vect const &next(waypoints[cur].next_wpts);
+		float best_dist(FLT_MAX);
+		int best(-1);
+
+		for (auto i = next.begin(); i != next.end(); ++i) {
+			if (dist[*i] == FLT_MAX) continue;
+			float const d(get_edge_cost(cur, *i) + dist[*i]);
+			if (d < best_dist) {best_dist = d; best = *i;}
+		}
+		return best;
+	}
+};
+
+wpt_goal_field_cache goal_field_cache;
+
+
 class waypoint_search {
 
 	wpt_goal goal;
@@ -604,32 +842,54 @@ class waypoint_search {
 		if (waypoints[cur].came_from >= 0) {reconstruct_path(waypoints[cur].came_from, path);}
 		path.push_back(cur);
 	}
-	void on_a_star_return(wpt_goal const &goal, bool orig_has_wpt_goal) {
+	void on_a_star_return(wpt_goal const &goal, bool orig_has_wpt_goal, unsigned orig_graph_version) {
 		if (goal.mode == 7) {
 			wb.remove_last_waypoint(); // goal position - remove temp waypoint
-			has_wpt_goal = orig_has_wpt_goal;
+			has_wpt_goal      = orig_has_wpt_goal;
+			wpt_graph_version = orig_graph_version; // the graph is back to its original state, so cached goal fields are still valid
 		}
 	}
+	bool resolve_goal_wpt() {
+		if (goal.mode == 4) { // specific waypoint
+			assert(goal.wpt < waypoints.size());
+			goal.pos = waypoints[goal.wpt].pos;
+		}
+		if (goal.mode == 5) {return wb.find_closest_waypoint(goal.pos, goal.wpt, 0);}
+		if (goal.mode == 6) {return wb.find_closest_waypoint(goal.pos, goal.wpt, 1);}
+		return 1;
+	}
 
 public:
 	waypoint_search(wpt_goal const &goal_, waypoint_cache &wc_) : goal(goal_), wc(wc_) {}
 
+	// returns false if this goal must use run_a_star(); otherwise sets dists to the shared goal distance field, or nullptr if there's no goal
+	bool get_goal_dists(vector<float> const *&dists) {
+		dists = nullptr;
+		if (goal.mode == 7) return 0; // temp goal waypoints modify the graph, so they can't be shared
+		if (!goal.is_reachable()) return 1;
+		vector<unsigned> goals;
+
+		if (goal.mode >= 4) {
+			if (!resolve_goal_wpt() || int(goal.wpt) < 0) return 1;
+			goals.push_back(goal.wpt);
+		}
+		else {
+			for (unsigned i = 0; i < waypoints.size(); ++i) {
+				if (is_goal(i)) {goals.push_back(i);}
+			}
+		}
+		dists = &goal_field_cache.get_dists(goals);
+		return 1;
+	}
+
 	// returns min distance to goal following connected waypoints along path
 	float run_a_star(vector<pair<unsigned, float> > const &start, vector<unsigned> &path, set<unsigned> const &wps_penalty) {
 		if (!goal.is_reachable()) return 0.0; // nothing to do
 		assert(path.empty());
 		bool const orig_has_wpt_goal(has_wpt_goal);
 		
-		if (goal.mode == 4) { // specific waypoint
-			assert(goal.wpt < waypoints.size());
-			goal.pos = waypoints[goal.wpt].pos;
-		}
-		if (goal.mode == 5) {
-			if (!wb.find_closest_waypoint(goal.pos, goal.wpt, 0)) return 0.0;
-		}
-		if (goal.mode == 6) {
-			if (!wb.find_closest_waypoint(goal.pos, goal.wpt, 1)) return 0.0;
-		}
+		if (!resolve_goal_wpt()) return 0.0;
+		unsigned const orig_graph_version(wpt_graph_version);
 		if (goal.mode == 7) {goal.wpt = wb.add_new_waypoint(goal.pos, -1, 1, 1, 1, 1);} // goal position - add temp waypoint
 		if (goal.mode == 7) {has_wpt_goal = 1;}
 		//cout << "start: " << start.size() << ", goal: mode: " << goal.mode << ", pos: " << goal.pos.str() << ", wpt: " << goal.wpt << endl;
@@ -650,7 +910,7 @@ public:
 
 			if (is_goal(ix)) { // already at the goal
 				path.push_back(ix);
-				on_a_star_return(goal, orig_has_wpt_goal);
+				on_a_star_return(goal, orig_has_wpt_goal, orig_graph_version);
 				return w.f_score;
 			}
 			wc.open[ix] = wc.call_ix;
@@ -658,7 +918,7 @@ public:
 		} // for i
 		if (goal.mode >= 4) {
 			assert(goal.wpt < waypoints.size());
-			if (waypoints[goal.wpt].unreachable()) {on_a_star_return(goal, orig_has_wpt_goal); return 0.0;} // goal has no incoming edges - unreachable
+			if (waypoints[goal.wpt].unreachable()) {on_a_star_return(goal, orig_has_wpt_goal, orig_graph_version); return 0.0;} // goal has no incoming edges - unreachable
 		}
 		float min_dist(0.0);
 
@@ -691,7 +951,7 @@ public:
 				open_queue.push(make_pair(-wn.f_score, *i));
 			} // for i
 		} // end while()
-		on_a_star_return(goal, orig_has_wpt_goal);
+		on_a_star_return(goal, orig_has_wpt_goal, orig_graph_version);
 		return min_dist;
 	}
 };
@@ -705,6 +965,7 @@ void create_waypoints(vector<user_waypt_t> const &user_waypoints) {
 	RESET_TIME;
 	clear_cached_waypoints();
 	waypoints.clear();
+	goal_field_cache.clear();
 	has_user_placed = (!user_waypoints.empty());
 	has_item_placed = 0;
 	has_wpt_goal    = 0;
@@ -733,6 +994,8 @@ int find_optimal_next_waypoint(unsigned cur, wpt_goal const &goal, set<unsigned>
 	//RESET_TIME;
 	vector<unsigned> path;
 	waypoint_search ws(goal, global_wpt_cache);
+	vector<float> const *dists(nullptr);
+	if (ws.get_goal_dists(dists)) {return (dists ? wpt_goal_field_cache::get_next_waypoint(*dists, cur) : -1);} // shared field lookup
 	vector<pair<unsigned, float> > start;
 	start.push_back(make_pair(cur, 0.0));
 	ws.run_a_star(start, path, wps_penalty);
@@ -774,8 +1037,20 @@ void find_optimal_waypoint(point const &pos, vector<od_data> &oddatav, wpt_goal
 		}
 	}
 	waypoint_search ws(goal, global_wpt_cache);
+	vector<float> const *dists(nullptr);
 	vector<unsigned> path;
-	ws.run_a_star(start, path, set<unsigned>());
+
+	if (ws.get_goal_dists(dists)) { // choose the start with the shortest total path using the shared field
+		if (dists == nullptr) return; // no goal
+		float best_dist(FLT_MAX);
+
+		for (auto i = start.begin(); i != start.end(); ++i) {
+			float const d((*dists)[i->first]);
+			if (d == FLT_MAX) continue; // no path to goal
+			if (path.empty() || i->second + d < best_dist) {path.assign(1, i->first); best_dist = i->second + d;}
+		}
+	}
+	else {ws.run_a_star(start, path, set<unsigned>());}
 	//PRINT_TIME("Find Optimal Waypoint");
 	if (path.empty()) return; // no path found, nothing to do
 	unsigned const best(path[0]);